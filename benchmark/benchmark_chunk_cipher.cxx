@@ -0,0 +1,119 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file benchmark_chunk_cipher.cxx
+ * @brief Benchmark for chunk encryption with different sizes of the source reads
+ */
+
+#define BENCHPRESS_CONFIG_MAIN
+#include "benchpress.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/VirgilChunkCipher.h>
+#include <virgil/crypto/VirgilDataSink.h>
+#include <virgil/crypto/VirgilDataSource.h>
+
+using std::placeholders::_1;
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilChunkCipher;
+using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilDataSource;
+
+static constexpr size_t kTestDataSize = 64 * 1024 * 1024;
+
+/**
+ * @brief Return data from the memory by portions of the given size.
+ */
+class MemoryDataSource : public VirgilDataSource {
+public:
+    MemoryDataSource(const VirgilByteArray& data, size_t readSize) : data_(data), readSize_(readSize), offset_(0) {}
+
+    bool hasData() override {
+        return offset_ < data_.size();
+    }
+
+    VirgilByteArray read() override {
+        const size_t readSize = std::min(readSize_, data_.size() - offset_);
+        VirgilByteArray result(data_.cbegin() + offset_, data_.cbegin() + offset_ + readSize);
+        offset_ += readSize;
+        return result;
+    }
+
+private:
+    const VirgilByteArray& data_;
+    const size_t readSize_;
+    size_t offset_;
+};
+
+/**
+ * @brief Drop all written data.
+ */
+class NullDataSink : public VirgilDataSink {
+public:
+    bool isGood() override {
+        return true;
+    }
+
+    void write(const VirgilByteArray&) override {
+    }
+};
+
+void benchmark_chunk_encrypt(benchpress::context* ctx, size_t readSize) {
+    const VirgilByteArray testData(kTestDataSize, 0xAB);
+    VirgilChunkCipher cipher;
+    cipher.addPasswordRecipient(VirgilByteArrayUtils::stringToBytes("password"));
+
+    ctx->set_bytes(kTestDataSize);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        MemoryDataSource source(testData, readSize);
+        NullDataSink sink;
+        cipher.encrypt(source, sink, true, 64 * 1024);
+    }
+}
+
+BENCHMARK("Chunk encrypt 64 MiB -> 4 KiB reads ", std::bind(benchmark_chunk_encrypt, _1, 4 * 1024));
+BENCHMARK("Chunk encrypt 64 MiB -> 64 KiB reads", std::bind(benchmark_chunk_encrypt, _1, 64 * 1024));
+BENCHMARK("Chunk encrypt 64 MiB -> 1 MiB reads ", std::bind(benchmark_chunk_encrypt, _1, 1024 * 1024));
+BENCHMARK("Chunk encrypt 64 MiB -> 16 MiB reads", std::bind(benchmark_chunk_encrypt, _1, 16 * 1024 * 1024));
+BENCHMARK("Chunk encrypt 64 MiB -> 64 MiB reads", std::bind(benchmark_chunk_encrypt, _1, 64 * 1024 * 1024));
@@ -44,11 +44,13 @@
 #include "benchpress.hpp"
 
 #include <functional>
+#include <string>
 
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilKeyPair.h>
 #include <virgil/crypto/VirgilCipher.h>
+#include <virgil/crypto/VirgilRecipientSet.h>
 
 using std::placeholders::_1;
 
@@ -56,6 +58,7 @@ using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilKeyPair;
 using virgil::crypto::VirgilCipher;
+using virgil::crypto::VirgilRecipientSet;
 
 void benchmark_encrypt(benchpress::context* ctx, const VirgilKeyPair::Type& keyType) {
     VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be encrypted");
@@ -86,6 +89,29 @@ void benchmark_decrypt(benchpress::context* ctx, const VirgilKeyPair::Type& keyT
     }
 }
 
+void benchmark_encrypt_recipients(
+        benchpress::context* ctx, const VirgilKeyPair::Type& keyType, size_t recipientsNum, bool useRecipientSet) {
+    VirgilByteArray testData = VirgilByteArrayUtils::stringToBytes("this string will be encrypted");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(keyType);
+
+    VirgilCipher cipher;
+    VirgilRecipientSet recipients;
+    for (size_t i = 0; i < recipientsNum; ++i) {
+        VirgilByteArray recipientId = VirgilByteArrayUtils::stringToBytes("recipient-" + std::to_string(i));
+        if (useRecipientSet) {
+            recipients.addKeyRecipient(recipientId, keyPair.publicKey());
+        } else {
+            cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+        }
+    }
+    cipher.addKeyRecipients(recipients);
+
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        (void)cipher.encrypt(testData, true);
+    }
+}
+
 BENCHMARK("Encrypt -> RSA 2048                ", std::bind(benchmark_encrypt, _1, VirgilKeyPair::Type::RSA_2048));
 BENCHMARK("Encrypt -> RSA 3072                ", std::bind(benchmark_encrypt, _1, VirgilKeyPair::Type::RSA_3072));
 BENCHMARK("Encrypt -> RSA 4096                ", std::bind(benchmark_encrypt, _1, VirgilKeyPair::Type::RSA_4096));
@@ -102,6 +128,19 @@ BENCHMARK("Encrypt -> 192-bits 'Koblitz' curve", std::bind(benchmark_encrypt, _1
 BENCHMARK("Encrypt -> 224-bits 'Koblitz' curve", std::bind(benchmark_encrypt, _1, VirgilKeyPair::Type::EC_SECP224K1));
 BENCHMARK("Encrypt -> 256-bits 'Koblitz' curve", std::bind(benchmark_encrypt, _1, VirgilKeyPair::Type::EC_SECP256K1));
 
+BENCHMARK("Encrypt -> 16 recipients, Curve25519 curve                  ",
+        std::bind(benchmark_encrypt_recipients, _1, VirgilKeyPair::Type::FAST_EC_X25519, 16, false));
+BENCHMARK("Encrypt -> 16 recipients, Curve25519 curve, recipient set   ",
+        std::bind(benchmark_encrypt_recipients, _1, VirgilKeyPair::Type::FAST_EC_X25519, 16, true));
+BENCHMARK("Encrypt -> 16 recipients, 256-bits NIST curve               ",
+        std::bind(benchmark_encrypt_recipients, _1, VirgilKeyPair::Type::EC_SECP256R1, 16, false));
+BENCHMARK("Encrypt -> 16 recipients, 256-bits NIST curve, recipient set",
+        std::bind(benchmark_encrypt_recipients, _1, VirgilKeyPair::Type::EC_SECP256R1, 16, true));
+BENCHMARK("Encrypt -> 16 recipients, RSA 2048                          ",
+        std::bind(benchmark_encrypt_recipients, _1, VirgilKeyPair::Type::RSA_2048, 16, false));
+BENCHMARK("Encrypt -> 16 recipients, RSA 2048, recipient set           ",
+        std::bind(benchmark_encrypt_recipients, _1, VirgilKeyPair::Type::RSA_2048, 16, true));
+
 BENCHMARK("Decrypt -> RSA 2048                ", std::bind(benchmark_decrypt, _1, VirgilKeyPair::Type::RSA_2048));
 BENCHMARK("Decrypt -> RSA 3072                ", std::bind(benchmark_decrypt, _1, VirgilKeyPair::Type::RSA_3072));
 BENCHMARK("Decrypt -> RSA 4096                ", std::bind(benchmark_decrypt, _1, VirgilKeyPair::Type::RSA_4096));
@@ -44,6 +44,7 @@
 #include "benchpress.hpp"
 
 #include <functional>
+#include <vector>
 
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
@@ -83,3 +84,39 @@ BENCHMARK("Hash -> SHA-512", [](benchpress::context* ctx){
     benchmark_hash(ctx, VirgilHash::Algorithm::SHA512);
 });
 
+
+constexpr size_t kBatchMessagesNum = 1024;
+constexpr size_t kBatchMessageSize = 64;
+
+void benchmark_hash_messages(benchpress::context* ctx, VirgilHash::Algorithm hashAlg) {
+    VirgilRandom random(VirgilByteArrayUtils::stringToBytes("seed"));
+    VirgilByteArray testData = random.randomize(kBatchMessagesNum * kBatchMessageSize);
+    VirgilHash hash(hashAlg);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        for (size_t messageIndex = 0; messageIndex < kBatchMessagesNum; ++messageIndex) {
+            (void)hash.hash(testData.data() + messageIndex * kBatchMessageSize, kBatchMessageSize);
+        }
+    }
+}
+
+void benchmark_hash_batch(benchpress::context* ctx, VirgilHash::Algorithm hashAlg, size_t threadsNum) {
+    VirgilRandom random(VirgilByteArrayUtils::stringToBytes("seed"));
+    VirgilByteArray testData = random.randomize(kBatchMessagesNum * kBatchMessageSize);
+    std::vector<VirgilHash::InputSegment> messages;
+    for (size_t messageIndex = 0; messageIndex < kBatchMessagesNum; ++messageIndex) {
+        messages.push_back({ testData.data() + messageIndex * kBatchMessageSize, kBatchMessageSize });
+    }
+    VirgilHash hash(hashAlg);
+    ctx->reset_timer();
+    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
+        (void)hash.hashBatch(messages, threadsNum);
+    }
+}
+
+BENCHMARK("Hash 1024 x 64 bytes -> SHA-256 one by one       ", std::bind(benchmark_hash_messages, _1, VirgilHash::Algorithm::SHA256));
+BENCHMARK("Hash 1024 x 64 bytes -> SHA-256 batch            ", std::bind(benchmark_hash_batch, _1, VirgilHash::Algorithm::SHA256, 1));
+BENCHMARK("Hash 1024 x 64 bytes -> SHA-256 batch, 4 threads ", std::bind(benchmark_hash_batch, _1, VirgilHash::Algorithm::SHA256, 4));
+BENCHMARK("Hash 1024 x 64 bytes -> SHA-512 one by one       ", std::bind(benchmark_hash_messages, _1, VirgilHash::Algorithm::SHA512));
+BENCHMARK("Hash 1024 x 64 bytes -> SHA-512 batch            ", std::bind(benchmark_hash_batch, _1, VirgilHash::Algorithm::SHA512, 1));
+BENCHMARK("Hash 1024 x 64 bytes -> SHA-512 batch, 4 threads ", std::bind(benchmark_hash_batch, _1, VirgilHash::Algorithm::SHA512, 4));
@@ -106,6 +106,8 @@ public:
 
     /**
      * @brief Return first num bytes and remove it from the src
+     * @note Remaining bytes are shifted on every call, so draining big buffer by small portions
+     *     takes quadratic time.
      */
     static VirgilByteArray popBytes(VirgilByteArray& src, size_t num);
 
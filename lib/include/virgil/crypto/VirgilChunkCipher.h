@@ -42,6 +42,7 @@
 #include "VirgilCipherBase.h"
 #include "VirgilByteArray.h"
 #include "VirgilDataSource.h"
+#include "VirgilSeekableDataSource.h"
 #include "VirgilDataSink.h"
 
 namespace virgil { namespace crypto {
@@ -50,6 +51,8 @@ namespace virgil { namespace crypto {
  * @brief This class provides high-level interface to encrypt / decrypt data splitted to chunks.
  * @note Virgil Security keys is used for encryption and decryption.
  * @note This class algorithms are not compatible with VirgilCipher and VirgilStreamCipher class algorithms.
+ * @note If source implements VirgilDataReader, or sink implements VirgilDataWriter,
+ *     then chunks are read / written directly within reused buffers.
  */
 class VirgilChunkCipher : public VirgilCipherBase {
 public:
@@ -62,8 +65,32 @@ public:
      * @brief Recommended chunk size.
      */
     static constexpr size_t kPreferredChunkSize = 1024 * 1024;
+    /**
+     * @property kChunksPerThread
+     * @brief Number of chunks that are read ahead for each thread during multi-threaded processing.
+     */
+    static constexpr size_t kChunksPerThread = 2;
     ///@}
 public:
+    /**
+     * @brief Define number of threads used to encrypt / decrypt chunks.
+     *
+     * Every chunk is processed with its own nonce, so chunks can be processed independently.
+     *     Up to threadsNum * kChunksPerThread chunks are read ahead, processed in parallel,
+     *     and then written to the sink in the original order.
+     *
+     * @param threadsNum - number of threads, 1 means processing within calling thread.
+     * @note Default value is 1.
+     * @note Data encrypted by the previous library versions is always decrypted within calling thread.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument, if threadsNum is zero.
+     */
+    void setChunkProcessingThreads(size_t threadsNum);
+
+    /**
+     * @brief Return number of threads used to encrypt / decrypt chunks.
+     */
+    size_t getChunkProcessingThreads() const;
+
     /**
      * @brief Encrypt data read from given source and write it the sink.
      * @param source - source of the data to be encrypted.
@@ -95,6 +122,36 @@ public:
      */
     void decryptWithPassword(VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& pwd);
 
+    /**
+     * @brief Decrypt only given range of the original data read from given source
+     *     for recipient defined by id and private key, and write it to the sink.
+     *
+     * Only chunks that cover requested range are read and decrypted.
+     *
+     * @param source - source of the encrypted data, it is read from the beginning.
+     * @param sink - target sink for decrypted data.
+     * @param offset - offset of the range within original (decrypted) data.
+     * @param length - length of the range, it is truncated if range exceeds the end of the original data.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidFormat,
+     *     if data was encrypted by the previous library versions, that do not support random access.
+     * @see method setContentInfo().
+     */
+    void decryptRangeWithKey(
+            VirgilSeekableDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+            const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+            const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Decrypt only given range of the original data read from given source
+     *     for recipient defined by password, and write it to the sink.
+     *
+     * @see method decryptRangeWithKey() for details.
+     */
+    void decryptRangeWithPassword(
+            VirgilSeekableDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+            const VirgilByteArray& pwd);
+
 private:
     /**
      * @brief Store actual chunk size in the custom parameters.
@@ -106,10 +163,30 @@ private:
      */
     size_t retrieveChunkSize() const;
 
+    /**
+     * @brief Return true if nonce of every chunk is derived from the chunk index.
+     * @note It is false for data encrypted by the previous library versions.
+     */
+    bool hasIndexedChunkNonce() const;
+
     /**
      * @brief Do encryption / decryption depends on the configured mode.
      */
     void process(VirgilDataSource& source, VirgilDataSink& sink, size_t actualChunkSize);
+
+    /**
+     * @brief Do decryption of the data encrypted by the previous library versions.
+     */
+    void processLegacy(
+            VirgilDataSource& source, VirgilDataSink& sink, size_t actualChunkSize, VirgilByteArray contentData);
+
+    /**
+     * @brief Do decryption of the chunks that cover given range of the original data.
+     */
+    void processRange(VirgilSeekableDataSource& source, VirgilDataSink& sink, size_t offset, size_t length);
+
+private:
+    size_t chunkProcessingThreads_ = 1;
 };
 
 }}
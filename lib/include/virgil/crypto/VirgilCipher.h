@@ -70,6 +70,16 @@ public:
             const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
             const VirgilByteArray& privateKeyPassword = VirgilByteArray());
 
+    /**
+     * @brief Decrypt given data for recipient defined by id and already parsed private key.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @see method setContentInfo().
+     * @return Decrypted data.
+     */
+    VirgilByteArray decryptWithKey(
+            const VirgilByteArray& encryptedData,
+            const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
     /**
      * @brief Decrypt given data for recipient defined by password.
      * @note Content info MUST be defined, if it was not embedded to the encrypted data.
@@ -77,12 +87,131 @@ public:
      * @return Decrypted data.
      */
     VirgilByteArray decryptWithPassword(const VirgilByteArray& encryptedData, const VirgilByteArray& pwd);
+
+    /**
+     * @name Pointer and length based input
+     *
+     * Same as methods above, but input data is not copied.
+     */
+    ///@{
+    /**
+     * @brief Encrypt data given as pointer and length.
+     * @see encrypt(const VirgilByteArray&, bool)
+     */
+    VirgilByteArray encrypt(const unsigned char* data, size_t dataSize, bool embedContentInfo = true);
+
+    /**
+     * @brief Decrypt data given as pointer and length for recipient defined by id and private key.
+     * @see decryptWithKey(const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&, const VirgilByteArray&)
+     */
+    VirgilByteArray decryptWithKey(
+            const unsigned char* encryptedData, size_t encryptedDataSize,
+            const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+            const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Decrypt data given as pointer and length for recipient defined by id and already parsed private key.
+     * @see decryptWithKey(const VirgilByteArray&, const VirgilByteArray&, const VirgilPrivateKeyHandle&)
+     */
+    VirgilByteArray decryptWithKey(
+            const unsigned char* encryptedData, size_t encryptedDataSize,
+            const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
+    /**
+     * @brief Decrypt data given as pointer and length for recipient defined by password.
+     * @see decryptWithPassword(const VirgilByteArray&, const VirgilByteArray&)
+     */
+    VirgilByteArray decryptWithPassword(
+            const unsigned char* encryptedData, size_t encryptedDataSize, const VirgilByteArray& pwd);
+    ///@}
+
+    /**
+     * @name Caller provided output buffer
+     *
+     * Encrypt / decrypt data in one pass directly to the given buffer without intermediate allocations.
+     */
+    ///@{
+    /**
+     * @brief Return exact size of the data that will be produced by encryptInto().
+     *
+     * If encryption was not prepared yet, then content encryption key is generated
+     *     and encrypted for all recipients by this call, so following encryptInto() produces
+     *     exactly the same content info.
+     *
+     * @param dataSize - size of the data to be encrypted.
+     * @param embedContentInfo - determines whether content info will be embedded to the encrypted data, or not.
+     * @return Size of the encrypted data in bytes.
+     * @note Adding / removing recipients or changing content encryption algorithm discards prepared encryption,
+     *     so following encryptInto() prepares it again for the actual recipients, and returned size becomes stale.
+     *     Custom parameters are serialized by encryptInto(), so their change affects the size too.
+     *     In both cases encryptInto() throws if the buffer becomes too small.
+     */
+    size_t encryptedSize(size_t dataSize, bool embedContentInfo = true);
+
+    /**
+     * @brief Encrypt given data to the given buffer.
+     * @param data - data to be encrypted.
+     * @param dataSize - size of the data to be encrypted.
+     * @param output - buffer for the encrypted data, MUST NOT overlap with data.
+     * @param outputSize - output buffer size, MUST be at least encryptedSize().
+     * @param embedContentInfo - determines whether to embed content info the the encrypted data, or not.
+     * @return Number of bytes written to the output buffer.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if output buffer is too small,
+     *     prepared encryption is kept in this case.
+     */
+    size_t encryptInto(
+            const unsigned char* data, size_t dataSize, unsigned char* output, size_t outputSize,
+            bool embedContentInfo = true);
+
+    /**
+     * @brief Decrypt given data to the given buffer for recipient defined by id and private key.
+     * @param output - buffer for the decrypted data, MUST NOT overlap with encrypted data.
+     * @param outputSize - output buffer size, buffer of encryptedDataSize bytes is enough for authenticated
+     *     content (GCM), padded content (CBC) requires one cipher block (16 bytes) more.
+     * @return Number of bytes written to the output buffer.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if output buffer is too small.
+     */
+    size_t decryptInto(
+            const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize,
+            const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+            const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Decrypt given data to the given buffer for recipient defined by id and already parsed private key.
+     * @param output - buffer for the decrypted data, MUST NOT overlap with encrypted data.
+     * @param outputSize - output buffer size, buffer of encryptedDataSize bytes is enough for authenticated
+     *     content (GCM), padded content (CBC) requires one cipher block (16 bytes) more.
+     * @return Number of bytes written to the output buffer.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if output buffer is too small.
+     */
+    size_t decryptInto(
+            const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize,
+            const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
+    /**
+     * @brief Decrypt given data to the given buffer for recipient defined by password.
+     * @param output - buffer for the decrypted data, MUST NOT overlap with encrypted data.
+     * @param outputSize - output buffer size, buffer of encryptedDataSize bytes is enough for authenticated
+     *     content (GCM), padded content (CBC) requires one cipher block (16 bytes) more.
+     * @return Number of bytes written to the output buffer.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if output buffer is too small.
+     */
+    size_t decryptInto(
+            const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize,
+            const VirgilByteArray& pwd);
+    ///@}
 private:
     /**
-     * @brief Decrypt given data.
-     * @return Decrypted data.
+     * @brief Decrypt given data to the given buffer.
+     * @return Number of bytes written to the output buffer.
+     */
+    size_t decrypt(
+            const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize);
+
+    /**
+     * @brief Return size of the encrypted data without content info.
      */
-    VirgilByteArray decrypt(const VirgilByteArray& encryptedData);
+    size_t encryptedPayloadSize(size_t dataSize);
 };
 
 }}
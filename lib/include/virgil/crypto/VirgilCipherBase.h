@@ -43,15 +43,10 @@
 
 #include "VirgilByteArray.h"
 #include "VirgilCustomParams.h"
-
-/**
- * @name Forward declaration
- */
-/// @{
-namespace virgil { namespace crypto { namespace foundation {
-class VirgilSymmetricCipher;
-}}}
-/// @}
+#include "VirgilPrivateKeyHandle.h"
+#include "VirgilPublicKeyHandle.h"
+#include "VirgilRecipientSet.h"
+#include "foundation/VirgilSymmetricCipher.h"
 
 namespace virgil { namespace crypto {
 
@@ -78,6 +73,25 @@ public:
      */
     void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey);
 
+    /**
+     * @brief Add recipient defined with id and already parsed public key.
+     * @param recipientId Recipient's unique identifier, MUST not be empty.
+     * @param publicKey Recipient's public key.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument, if invalid arguments are given.
+     */
+    void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilPublicKeyHandle& publicKey);
+
+    /**
+     * @brief Add all recipients from the given set.
+     *
+     * Public keys within the set are already parsed, so they are not parsed again during encryption.
+     *
+     * @param recipients Set of key recipients.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument,
+     *     if any recipient from the set is already added. No recipients are added in this case.
+     */
+    void addKeyRecipients(const VirgilRecipientSet& recipients);
+
     /**
      * @brief Remove recipient with given identifier.
      * @param recipientId Recipient's unique identifier.
@@ -128,6 +142,47 @@ public:
      * @brief Remove all recipients.
      */
     void removeAllRecipients();
+
+    /**
+     * @brief Define number of threads used to encrypt content key for key recipients.
+     *
+     * Content key is encrypted with an asymmetric operation for each key recipient,
+     *     so encryption for a large number of recipients can be spread over several threads.
+     *
+     * @param threadsNum - number of threads, 1 means encryption within calling thread.
+     * @note Recipients order within content info does not depend on the number of threads.
+     * @note Default value is 1.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument, if threadsNum is zero.
+     */
+    void setRecipientEncryptionThreads(size_t threadsNum);
+
+    /**
+     * @brief Return number of threads used to encrypt content key for key recipients.
+     */
+    size_t getRecipientEncryptionThreads() const;
+    ///@}
+    /**
+     * @name Content Encryption Algorithm
+     */
+    ///@{
+    /**
+     * @brief Define symmetric algorithm that is used to encrypt content by this instance.
+     *
+     * Algorithm is stored within content info, so decryption picks it up automatically,
+     *     and no configuration is required on the recipient side.
+     *
+     * @param algorithm - authenticated content encryption algorithm: AES-128-GCM or AES-256-GCM.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument, if algorithm is not authenticated,
+     *     because content encrypted without authentication can be modified undetectably.
+     * @note Default value is AES-256-GCM.
+     * @note AES-128-GCM requires less rounds per block, so it can be preferred on CPUs without AES instructions.
+     */
+    void setContentEncryptionAlgorithm(foundation::VirgilSymmetricCipher::Algorithm algorithm);
+
+    /**
+     * @brief Return symmetric algorithm that is used to encrypt content by this instance.
+     */
+    foundation::VirgilSymmetricCipher::Algorithm getContentEncryptionAlgorithm() const;
     ///@}
     /**
      * @name Content Info Access / Management
@@ -202,6 +257,19 @@ public:
     static VirgilByteArray computeShared(
             const VirgilByteArray& publicKey,
             const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Compute shared secret key on a given already parsed keys
+     *
+     * @param publicKey - alice public key.
+     * @param privateKey - bob private key.
+     *
+     * @throw VirgilCryptoException - if keys are not compatible.
+     *
+     * @warning Keys SHOULD be of the identical type, i.e. both of type Curve25519.
+     */
+    static VirgilByteArray computeShared(
+            const VirgilPublicKeyHandle& publicKey, const VirgilPrivateKeyHandle& privateKey);
     ///@}
 
 protected:
@@ -216,6 +284,34 @@ protected:
      */
     VirgilByteArray filterAndSetupContentInfo(const VirgilByteArray& encryptedData, bool isLastChunk);
 
+    /**
+     * @brief Extract content info from the encrypted data and setup it.
+     *
+     * Same as @link filterAndSetupContentInfo() @endlink, but encrypted data that follows content info
+     *     is not copied, instead offset within given data is returned.
+     *
+     * @param encryptedData - data that was encrypted.
+     * @param encryptedDataSize - size of the data that was encrypted.
+     * @param isLastChunk - tell filter that given data is the last one.
+     * @param heldData - encrypted data that was buffered from the previous chunks, it precedes returned offset.
+     * return Offset of the encrypted data that is follows content info, if content info was fully extracted,
+     *     otherwise - size of the given data.
+     */
+    size_t filterAndSetupContentInfo(
+            const unsigned char* encryptedData, size_t encryptedDataSize, bool isLastChunk,
+            VirgilByteArray& heldData);
+
+    /**
+     * @brief Extract content info from the whole encrypted data and setup it.
+     *
+     * Same as @link filterAndSetupContentInfo() @endlink, but data is not copied.
+     *
+     * @param encryptedData - data that was encrypted.
+     * @param encryptedDataSize - size of the data that was encrypted.
+     * return Size of the content info at the beginning of the encrypted data, or 0 if it is absent.
+     */
+    size_t setupContentInfo(const unsigned char* encryptedData, size_t encryptedDataSize);
+
     /**
      * @brief Configures symmetric cipher for encryption.
      * @note cipher's key randomly generated.
@@ -239,6 +335,13 @@ protected:
             const VirgilByteArray& recipientId,
             const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword);
 
+    /**
+     * @brief Stores recipient's information that is used for cipher's key decryption when content becomes available.
+     * @param recipientId - recipient's id.
+     * @param privateKey - recipient's already parsed private key.
+     */
+    void initDecryptionWithKey(const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey);
+
     /**
      * Return true if one one of the init function was called.
      */
@@ -260,6 +363,16 @@ protected:
      */
     virgil::crypto::foundation::VirgilSymmetricCipher& getSymmetricCipher();
 
+    /**
+     * @brief Create new symmetric cipher configured with the same algorithm, key, IV and mode
+     *     as the one returned by the method @link getSymmetricCipher() @endlink.
+     *
+     * Independent ciphers allow to process data within several threads.
+     * @note Returned cipher MUST be reset before use.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if cipher is not initialized yet.
+     */
+    virgil::crypto::foundation::VirgilSymmetricCipher cloneSymmetricCipher() const;
+
     /**
      * @brief Build VirgilContentInfo object.
      *
@@ -304,6 +417,11 @@ private:
      */
     void accomplishInitDecryption();
 
+    /**
+     * @brief Drop prepared encryption, if any, so next encryption uses actual recipients and algorithm.
+     */
+    void discardPreparedEncryption();
+
 private:
     class Impl;
 
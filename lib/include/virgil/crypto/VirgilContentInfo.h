@@ -203,7 +203,9 @@ private:
         VirgilByteArray encryptedContent;
     };
 
-    void encryptKeyRecipients(std::function<EncryptionResult(const VirgilByteArray& publicKey)> encrypt);
+    void encryptKeyRecipients(
+            std::function<EncryptionResult(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey)> encrypt,
+            size_t threadsNum = 1);
 
     void encryptPasswordRecipients(std::function<EncryptionResult(const VirgilByteArray& pwd)> encrypt);
 
@@ -50,6 +50,9 @@
 #include "VirgilDataSink.h"
 #include "VirgilDataSource.h"
 #include "VirgilKeyPair.h"
+#include "VirgilPrivateKeyHandle.h"
+#include "VirgilPublicKeyHandle.h"
+#include "VirgilRecipientSet.h"
 #include "VirgilSigner.h"
 #include "VirgilSignerBase.h"
 #include "VirgilStreamCipher.h"
@@ -71,8 +74,10 @@
 #include "foundation/VirgilHash.h"
 #include "foundation/VirgilHKDF.h"
 #include "foundation/VirgilKDF.h"
+#include "foundation/VirgilKeyedCipher.h"
 #include "foundation/VirgilPBE.h"
 #include "foundation/VirgilPBKDF.h"
+#include "foundation/VirgilPrivateKeyCache.h"
 #include "foundation/VirgilRandom.h"
 #include "foundation/VirgilSymmetricCipher.h"
 #include "foundation/VirgilSystemCryptoError.h"
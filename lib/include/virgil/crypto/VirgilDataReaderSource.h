@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_DATA_READER_SOURCE_H
+#define VIRGIL_CRYPTO_VIRGIL_DATA_READER_SOURCE_H
+
+#include "VirgilByteArray.h"
+#include "VirgilDataReader.h"
+#include "VirgilDataSource.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Adapter that allows to use VirgilDataReader as VirgilDataSource.
+ *
+ * Adapter implements both interfaces, so functions that detect VirgilDataReader
+ *     still read data to their own buffers without intermediate allocations.
+ *
+ * @note This class CAN not be used in wrappers.
+ */
+class VirgilDataReaderSource : public VirgilDataSource, public VirgilDataReader {
+public:
+    /**
+     * @brief Default size of the data that is returned by @link read() @endlink method.
+     */
+    static constexpr size_t kChunkSizeDefault = 64 * 1024;
+
+    /**
+     * @brief Create source based on the given reader.
+     * @param reader - reader to be adapted, it MUST outlive the source.
+     * @param chunkSize - maximum size of the data that will be returned by @link read() @endlink method.
+     */
+    explicit VirgilDataReaderSource(VirgilDataReader& reader, size_t chunkSize = kChunkSizeDefault);
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::hasData() @endlink method.
+     */
+    virtual bool hasData();
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::read() @endlink method.
+     */
+    virtual VirgilByteArray read();
+
+    /**
+     * @brief Overriding of @link VirgilDataReader::readInto() @endlink method.
+     */
+    virtual size_t readInto(unsigned char* buffer, size_t bufferSize);
+
+private:
+    VirgilDataReader& reader_;
+    const size_t chunkSize_;
+};
+
+}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_DATA_READER_SOURCE_H */
@@ -0,0 +1,116 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_RECIPIENT_SET_H
+#define VIRGIL_CRYPTO_VIRGIL_RECIPIENT_SET_H
+
+#include <map>
+
+#include "VirgilByteArray.h"
+#include "VirgilPublicKeyHandle.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Reusable set of key recipients with already parsed public keys.
+ *
+ * Public keys are validated and parsed once, when recipient is added to the set.
+ *     The set can then be added to any number of ciphers, which encrypt for it without parsing keys again.
+ *
+ * Set is cheap to copy, copies share parsed keys.
+ *
+ * @see VirgilCipherBase::addKeyRecipients()
+ */
+class VirgilRecipientSet {
+public:
+    /**
+     * @name Recipient management
+     */
+    ///@{
+    /**
+     * @brief Add recipient defined with id and public key.
+     * @param recipientId Recipient's unique identifier, MUST not be empty.
+     * @param publicKey Recipient's public key, MUST not be empty.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument,
+     *     if recipient identifier is empty or recipient with given identifier already exists.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidPublicKey, if public key can not be parsed.
+     */
+    void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Add recipient defined with id and already parsed public key.
+     * @param recipientId Recipient's unique identifier, MUST not be empty.
+     * @param publicKey Recipient's public key.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument,
+     *     if recipient identifier is empty or recipient with given identifier already exists.
+     */
+    void addKeyRecipient(const VirgilByteArray& recipientId, const VirgilPublicKeyHandle& publicKey);
+
+    /**
+     * @brief Remove recipient with given identifier.
+     * @note If recipient with given identifier is absent - do nothing.
+     */
+    void removeKeyRecipient(const VirgilByteArray& recipientId);
+
+    /**
+     * @brief Check whether recipient with given identifier exists.
+     */
+    bool keyRecipientExists(const VirgilByteArray& recipientId) const;
+
+    /**
+     * @brief Return number of recipients.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Return true if set has no recipients.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Remove all recipients.
+     */
+    void clear();
+    ///@}
+private:
+    std::map<VirgilByteArray, VirgilPublicKeyHandle> keyRecipients_;
+
+    friend class VirgilCipherBase;
+};
+
+}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_RECIPIENT_SET_H */
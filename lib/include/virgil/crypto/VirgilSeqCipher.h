@@ -49,6 +49,22 @@ namespace virgil { namespace crypto {
  */
 class VirgilSeqCipher : public VirgilCipherBase {
 public:
+    /**
+     * @brief Read-only contiguous part of the data that is used for vectored processing.
+     */
+    struct InputSegment {
+        const unsigned char* data; ///< Pointer to the data.
+        size_t size; ///< Size of the data.
+    };
+
+    /**
+     * @brief Writable contiguous part of the buffer that is used for vectored processing.
+     */
+    struct OutputSegment {
+        unsigned char* data; ///< Pointer to the buffer.
+        size_t size; ///< Size of the buffer.
+    };
+
     /**
      * @brief Start sequential encryption process.
      * @note Store content info to use it for decryption process, or use it as beginning of encrypted data (embedding).
@@ -78,6 +94,37 @@ public:
      */
     VirgilByteArray process(const VirgilByteArray& data);
 
+    /**
+     * @name Vectored processing
+     *
+     * Process many data segments within single call without intermediate allocations.
+     */
+    ///@{
+    /**
+     * @brief Return size of the output that is enough to process data of the given size with processv().
+     */
+    static size_t processvOutputSize(size_t dataSize);
+
+    /**
+     * @brief Encrypt or decrypt given data segments depends on the current sequential mode.
+     *
+     * Input segments are processed as one contiguous data, so result is the same as
+     *     multiple calls of the method @link process() @endlink for every segment.
+     *     Result is written to the output segments sequentially: next segment is used when previous is full.
+     *
+     * @param inputs - data segments to be processed.
+     * @param inputsNum - number of the data segments.
+     * @param outputs - buffer segments for the processed data, MUST NOT overlap with inputs.
+     * @param outputsNum - number of the buffer segments.
+     * @return Number of bytes written to the output segments.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument,
+     *     if total size of the output segments is less than processvOutputSize() of the total input size,
+     *     nothing is processed in this case.
+     */
+    size_t processv(
+            const InputSegment* inputs, size_t inputsNum, const OutputSegment* outputs, size_t outputsNum);
+    ///@}
+
     /**
      * Accomplish sequential encryption or decryption depends on the mode.
      * @return plain text, if cipher in the decryption mode, encrypted data, if cipher in the encryption mode.
@@ -72,6 +72,52 @@ public:
      * @return true if sign is valid and data was not malformed.
      */
     bool verify(const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Sign data with already parsed private key.
+     * @return Virgil Security sign.
+     */
+    VirgilByteArray sign(const VirgilByteArray& data, const VirgilPrivateKeyHandle& privateKey);
+
+    /**
+     * @brief Verify sign and data to be conformed to the already parsed public key.
+     * @return true if sign is valid and data was not malformed.
+     */
+    bool verify(const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilPublicKeyHandle& publicKey);
+
+    /**
+     * @brief Sign data given as pointer and length with given private key.
+     * @note Data is hashed in place, without copying.
+     * @return Virgil Security sign.
+     */
+    VirgilByteArray sign(
+            const unsigned char* data, size_t dataSize, const VirgilByteArray& privateKey,
+            const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Verify sign and data given as pointer and length to be conformed to the given public key.
+     * @note Data is hashed in place, without copying.
+     * @return true if sign is valid and data was not malformed.
+     */
+    bool verify(
+            const unsigned char* data, size_t dataSize, const VirgilByteArray& sign,
+            const VirgilByteArray& publicKey);
+
+    /**
+     * @brief Sign data given as pointer and length with already parsed private key.
+     * @note Data is hashed in place, without copying.
+     * @return Virgil Security sign.
+     */
+    VirgilByteArray sign(const unsigned char* data, size_t dataSize, const VirgilPrivateKeyHandle& privateKey);
+
+    /**
+     * @brief Verify sign and data given as pointer and length to be conformed to the already parsed public key.
+     * @note Data is hashed in place, without copying.
+     * @return true if sign is valid and data was not malformed.
+     */
+    bool verify(
+            const unsigned char* data, size_t dataSize, const VirgilByteArray& sign,
+            const VirgilPublicKeyHandle& publicKey);
 };
 
 }}
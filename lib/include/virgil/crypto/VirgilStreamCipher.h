@@ -42,14 +42,37 @@
 #include "VirgilByteArray.h"
 #include "VirgilDataSource.h"
 #include "VirgilDataSink.h"
+#include "VirgilDataReader.h"
+#include "VirgilDataWriter.h"
 
 namespace virgil { namespace crypto {
 
 /**
  * @brief This class provides high-level interface to encrypt / decrypt streaming data using Virgil Security keys.
+ *
+ * If pipeline is disabled, and source implements VirgilDataReader, and sink implements VirgilDataWriter,
+ *     then the whole stream is processed within fixed buffers, so no allocations are done per data portion.
  */
 class VirgilStreamCipher : public VirgilCipherBase {
 public:
+    /**
+     * @brief Define number of data portions that are buffered between pipeline stages.
+     *
+     * If depth is not zero, data is read from the source and written to the sink within separate threads,
+     *     while encryption / decryption is done within calling thread, so I/O latency does not stall the cipher.
+     *     Result is identical to the one produced without pipeline.
+     *
+     * @param depth - maximum number of portions within every queue, 0 disables pipeline.
+     * @note Default value is 0.
+     * @note Source and sink MUST allow to be used from the thread other than calling one.
+     */
+    void setPipelineDepth(size_t depth);
+
+    /**
+     * @brief Return number of data portions that are buffered between pipeline stages.
+     */
+    size_t getPipelineDepth() const;
+
     /**
      * @brief Encrypt data read from given source and write it the sink.
      * @param source - source of the data to be encrypted.
@@ -89,6 +112,14 @@ private:
      * @brief Decrypt data read from given source, and write it to the sink.
      */
     void decrypt(VirgilDataSource& source, VirgilDataSink& sink);
+
+    /**
+     * @brief Decrypt data read from given reader within fixed buffer, and write it to the writer.
+     */
+    void decryptBuffered(VirgilDataReader& reader, VirgilDataWriter& writer);
+
+private:
+    size_t pipelineDepth_ = 0;
 };
 
 }}
@@ -0,0 +1,140 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_STREAM_SIGN_CIPHER_H
+#define VIRGIL_STREAM_SIGN_CIPHER_H
+
+#include <memory>
+
+#include "VirgilCipherBase.h"
+
+#include "VirgilByteArray.h"
+#include "VirgilDataSource.h"
+#include "VirgilDataSink.h"
+#include "foundation/VirgilHash.h"
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief This class provides high-level interface to sign and encrypt streaming data
+ *     using Virgil Security keys within single pass.
+ *
+ * Plain data is hashed and encrypted within the same loop, so it is read only once.
+ * Signature is equal to the one produced by VirgilStreamSigner over the same data with the same hash algorithm.
+ *
+ * Signature placement depends on the content info embedding:
+ *     - if content info is embedded, signature is appended to the encrypted data as trailer,
+ *       because content info is written before the data is processed;
+ *     - otherwise, signature is stored within content info custom parameters.
+ *
+ * @note Encrypted data can not be decrypted by VirgilStreamCipher, if signature is stored as trailer.
+ */
+class VirgilStreamSignCipher : public VirgilCipherBase {
+public:
+    /**
+     * @brief Create cipher with predefined hash function.
+     * @note Specified hash function algorithm is used only during signing.
+     */
+    explicit VirgilStreamSignCipher(
+            foundation::VirgilHash::Algorithm hashAlgorithm = foundation::VirgilHash::Algorithm::SHA384);
+
+    /**
+     * @brief Sign and encrypt data read from given source, and write it the sink.
+     * @param source - source of the data to be signed and encrypted.
+     * @param sink - target sink for encrypted data.
+     * @param privateKey - signer's private key.
+     * @param privateKeyPassword - signer's private key password.
+     * @param embedContentInfo - determines whether to embed content info the the encrypted data, or not.
+     * @note Store content info to use it for decription process, if embedContentInfo parameter is false.
+     * @see getContentInfo()
+     */
+    void encrypt(
+            VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& privateKey,
+            const VirgilByteArray& privateKeyPassword = VirgilByteArray(), bool embedContentInfo = true);
+
+    /**
+     * @brief Decrypt data read from given source for recipient defined by id and private key,
+     *     write it to the sink, and verify signature.
+     * @param signerPublicKey - public key of the signer.
+     * @return true if signature is valid, false - otherwise.
+     * @warning Decrypted data is written to the sink before verification is done,
+     *     so it MUST be discarded if false is returned.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @see method setContentInfo().
+     */
+    bool decryptWithKey(
+            VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& recipientId,
+            const VirgilByteArray& privateKey, const VirgilByteArray& signerPublicKey,
+            const VirgilByteArray& privateKeyPassword = VirgilByteArray());
+
+    /**
+     * @brief Decrypt data read from given source for recipient defined by password,
+     *     write it to the sink, and verify signature.
+     * @param signerPublicKey - public key of the signer.
+     * @return true if signature is valid, false - otherwise.
+     * @warning Decrypted data is written to the sink before verification is done,
+     *     so it MUST be discarded if false is returned.
+     * @note Content info MUST be defined, if it was not embedded to the encrypted data.
+     * @see method setContentInfo().
+     */
+    bool decryptWithPassword(
+            VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& pwd,
+            const VirgilByteArray& signerPublicKey);
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilStreamSignCipher(VirgilStreamSignCipher&& rhs) noexcept;
+
+    VirgilStreamSignCipher& operator=(VirgilStreamSignCipher&& rhs) noexcept;
+
+    virtual ~VirgilStreamSignCipher() noexcept;
+    //! @endcond
+
+private:
+    /**
+     * @brief Decrypt data read from given source, write it to the sink, and verify signature.
+     */
+    bool decryptAndVerify(VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& signerPublicKey);
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}
+
+#endif /* VIRGIL_STREAM_SIGN_CIPHER_H */
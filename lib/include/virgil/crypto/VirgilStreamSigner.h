@@ -49,6 +49,9 @@ namespace virgil { namespace crypto {
  * @brief This class provides high-level interface to sign and verify data using Virgil Security keys.
  *
  * This module can sign / verify data provided by stream.
+ *
+ * If pipeline is disabled, and source implements VirgilDataReader,
+ *     then the whole stream is hashed within fixed buffer, so no allocations are done per data portion.
  */
 class VirgilStreamSigner : public VirgilSignerBase {
 public:
@@ -60,6 +63,24 @@ public:
             foundation::VirgilHash::Algorithm hashAlgorithm =
             foundation::VirgilHash::Algorithm::SHA384) : VirgilSignerBase (hashAlgorithm) {};
 
+    /**
+     * @brief Define number of data portions that are read ahead.
+     *
+     * If depth is not zero, data is read from the source within separate thread,
+     *     while hashing is done within calling thread, so I/O latency does not stall the hash function.
+     *     Result is identical to the one produced without pipeline.
+     *
+     * @param depth - maximum number of portions that are read ahead, 0 disables pipeline.
+     * @note Default value is 0.
+     * @note Source MUST allow to be used from the thread other than calling one.
+     */
+    void setPipelineDepth(size_t depth);
+
+    /**
+     * @brief Return number of data portions that are read ahead.
+     */
+    size_t getPipelineDepth() const;
+
     /**
      * @brief Sign data provided by the source with given private key.
      * @return Virgil Security sign.
@@ -73,6 +94,15 @@ public:
      * @return true if sign is valid and data was not malformed.
      */
     bool verify(VirgilDataSource& source, const VirgilByteArray& sign, const VirgilByteArray& publicKey);
+
+private:
+    /**
+     * @brief Update hash with all data provided by the source.
+     */
+    void updateHash(foundation::VirgilHash& hash, VirgilDataSource& source) const;
+
+private:
+    size_t pipelineDepth_ = 0;
 };
 
 }}
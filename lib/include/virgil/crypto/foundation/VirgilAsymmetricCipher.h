@@ -155,6 +155,7 @@ public:
      * @param pwd - private key password if exists.
      * @throw VirgilCryptoException with VirgilCryptoError::InvalidPrivateKey, if private key is invalid.
      * @throw VirgilCryptoException with VirgilCryptoError::InvalidPrivateKeyPassword, if private key password mismatch.
+     * @note Decrypted password-protected keys are reused if VirgilPrivateKeyCache is enabled.
      */
     void setPrivateKey(
             const virgil::crypto::VirgilByteArray& key,
@@ -39,6 +39,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "../VirgilByteArray.h"
 #include "asn1/VirgilAsn1Compatible.h"
@@ -63,6 +64,14 @@ public:
         SHA512  ///< Hash Algorithm: SHA512
     };
 
+    /**
+     * @brief Read-only contiguous message that is used for batch hashing.
+     */
+    struct InputSegment {
+        const unsigned char* data; ///< Pointer to the message.
+        size_t size; ///< Size of the message.
+    };
+
     /**
      * @name Constructor / Destructor
      */
@@ -135,6 +144,37 @@ public:
      * @return Hash of the given message.
      */
     virgil::crypto::VirgilByteArray hash(const virgil::crypto::VirgilByteArray& data) const;
+
+    /**
+     * @brief Produce hash of the message given as pointer and length.
+     *
+     * Same as @link hash(const VirgilByteArray&) @endlink, but data is not copied.
+     *
+     * @param data - message to be hashed.
+     * @param dataSize - message size.
+     * @return Hash of the given message.
+     */
+    virgil::crypto::VirgilByteArray hash(const unsigned char* data, size_t dataSize) const;
+    ///@}
+
+    /**
+     * @name Batch Hashing
+     * This methods can be used to get hashes of many independent messages at once.
+     */
+    ///@{
+    /**
+     * @brief Produce hashes of the given messages.
+     *
+     * Digests are written to the single buffer, so no allocation is made per message.
+     *     Each digest is the same as @link hash(const unsigned char*, size_t) @endlink returns for the message.
+     *
+     * @param messages - messages to be hashed, messages are not copied.
+     * @param threadsNum - number of threads, 1 means hashing within calling thread.
+     * @return Concatenated digests, digest of the i-th message starts at offset i * size().
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument,
+     *     if threadsNum is zero, or message has no data pointer but non-zero size.
+     */
+    virgil::crypto::VirgilByteArray hashBatch(const std::vector<InputSegment>& messages, size_t threadsNum = 1) const;
     ///@}
 
     /**
@@ -160,6 +200,14 @@ public:
      */
     void update(const virgil::crypto::VirgilByteArray& data);
 
+    /**
+     * @brief Update / process message hash with data given as pointer and length.
+     * @param data - message to be hashed.
+     * @param dataSize - message size.
+     * @see update(const VirgilByteArray&)
+     */
+    void update(const unsigned char* data, size_t dataSize);
+
     /**
      * @brief Return final message hash.
      * @return Message hash processed by series of @link update() @endlink method.
@@ -218,6 +266,14 @@ public:
      */
     void hmacUpdate(const virgil::crypto::VirgilByteArray& data);
 
+    /**
+     * @brief Update / process message HMAC hash with data given as pointer and length.
+     * @param data - message to be hashed.
+     * @param dataSize - message size.
+     * @see hmacUpdate(const VirgilByteArray&)
+     */
+    void hmacUpdate(const unsigned char* data, size_t dataSize);
+
     /**
      * @brief Return final message HMAC hash.
      * @return Message HMAC hash processed by series of @link hmacUpdate() @endlink method.
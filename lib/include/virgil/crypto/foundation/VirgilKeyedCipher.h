@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_FOUNDATION_VIRGIL_KEYED_CIPHER_H
+#define VIRGIL_CRYPTO_FOUNDATION_VIRGIL_KEYED_CIPHER_H
+
+#include <memory>
+
+#include "../VirgilByteArray.h"
+#include "VirgilSymmetricCipher.h"
+
+namespace virgil { namespace crypto { namespace foundation {
+
+/**
+ * @brief Authenticated symmetric cipher that is bound to the single key.
+ *
+ * Key schedule is computed once within constructor,
+ *     so many messages can be encrypted / decrypted with the same key without per-message key setup.
+ *
+ * @note Object is owned by the caller and is not thread-safe.
+ * @note Key schedule is zeroized when object is destroyed, key itself is not stored.
+ * @ingroup cipher
+ */
+class VirgilKeyedCipher {
+public:
+    /**
+     * @brief Create cipher and set up the key for both encryption and decryption.
+     * @param algorithm - authenticated encryption algorithm, i.e. AES-256-GCM.
+     * @param key - encryption / decryption key.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidArgument,
+     *     if algorithm is not authenticated, or key is invalid for the given algorithm.
+     */
+    VirgilKeyedCipher(VirgilSymmetricCipher::Algorithm algorithm, const VirgilByteArray& key);
+
+    /**
+     * @brief Return size of the key in octets.
+     */
+    size_t keyLength() const;
+
+    /**
+     * @brief Return size of the nonce in octets.
+     */
+    size_t nonceSize() const;
+
+    /**
+     * @brief Return size of the authentication tag in octets.
+     */
+    size_t authTagLength() const;
+
+    /**
+     * @brief Encrypt given plain text.
+     * @param plainText - data to be encrypted.
+     * @param nonce - unique nonce for the current key.
+     * @param authData - additional data that participate in an authentication.
+     * @return Cipher text followed by the authentication tag.
+     */
+    VirgilByteArray encrypt(
+            const VirgilByteArray& plainText, const VirgilByteArray& nonce,
+            const VirgilByteArray& authData = VirgilByteArray());
+
+    /**
+     * @brief Decrypt given cipher text.
+     * @param cipherText - cipher text followed by the authentication tag.
+     * @param nonce - nonce that was used for encryption.
+     * @param authData - additional data that was used for encryption.
+     * @return Plain text.
+     * @throw VirgilCryptoException with VirgilCryptoErrorCode::InvalidAuth, if authentication failed.
+     */
+    VirgilByteArray decrypt(
+            const VirgilByteArray& cipherText, const VirgilByteArray& nonce,
+            const VirgilByteArray& authData = VirgilByteArray());
+
+public:
+    //! @cond Doxygen_Suppress
+    VirgilKeyedCipher(VirgilKeyedCipher&& rhs) noexcept;
+
+    VirgilKeyedCipher& operator=(VirgilKeyedCipher&& rhs) noexcept;
+
+    ~VirgilKeyedCipher() noexcept;
+    //! @endcond
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_FOUNDATION_VIRGIL_KEYED_CIPHER_H */
@@ -0,0 +1,141 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_PRIVATE_KEY_CACHE_H
+#define VIRGIL_CRYPTO_PRIVATE_KEY_CACHE_H
+
+#include <cstddef>
+
+#include "../VirgilByteArray.h"
+
+namespace virgil { namespace crypto { namespace foundation {
+
+/**
+ * @brief Process-wide cache of decrypted private keys.
+ *
+ * Parsing a password-protected private key runs PKCS#5 key derivation, which is
+ *     deliberately slow. When the cache is enabled, VirgilAsymmetricCipher::setPrivateKey()
+ *     stores decrypted key material under a fingerprint of the (key, password) pair,
+ *     so subsequent calls with the same pair skip key derivation.
+ *     Every class built on top of VirgilAsymmetricCipher benefits without API changes.
+ *
+ * The cache is disabled by default, bounded by entry count and memory, evicts the least
+ *     recently used entry first, and zeroizes key material on eviction.
+ *
+ * @note Only password-protected keys are cached, since parsing of unprotected keys is cheap.
+ * @note All methods are thread-safe.
+ */
+class VirgilPrivateKeyCache {
+public:
+    /**
+     * @brief Enable cache with given limits.
+     *
+     * If cache is already enabled, limits are updated and exceeding entries are evicted.
+     *
+     * @param maxEntries - maximum number of cached keys, MUST be greater than zero.
+     * @param maxMemory - maximum amount of cached key material in bytes, MUST be greater than zero.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if any limit is zero.
+     */
+    static void enable(size_t maxEntries, size_t maxMemory);
+
+    /**
+     * @brief Disable cache and zeroize all cached entries.
+     */
+    static void disable();
+
+    /**
+     * @brief Return true if cache is enabled.
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Zeroize all cached entries, cache remains enabled.
+     */
+    static void clear();
+
+    /**
+     * @brief Reset hits and misses counters.
+     */
+    static void resetStats();
+
+    /**
+     * @brief Return number of lookups that found a cached key.
+     */
+    static size_t hits();
+
+    /**
+     * @brief Return number of lookups that did not find a cached key.
+     */
+    static size_t misses();
+
+    /**
+     * @brief Return number of cached keys.
+     */
+    static size_t size();
+
+    /**
+     * @brief Return amount of cached key material in bytes.
+     */
+    static size_t memoryUsage();
+
+public:
+    /**
+     * @brief Deny object creation.
+     */
+    VirgilPrivateKeyCache() = delete;
+
+private:
+    /**
+     * @brief Find decrypted key for the given (key, password) pair.
+     * @return true if key was found and written to decryptedKey.
+     */
+    static bool find(
+            const virgil::crypto::VirgilByteArray& key, const virgil::crypto::VirgilByteArray& pwd,
+            virgil::crypto::VirgilByteArray& decryptedKey);
+
+    /**
+     * @brief Store decrypted key for the given (key, password) pair.
+     */
+    static void store(
+            const virgil::crypto::VirgilByteArray& key, const virgil::crypto::VirgilByteArray& pwd,
+            virgil::crypto::VirgilByteArray decryptedKey);
+
+    friend class VirgilAsymmetricCipher;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_PRIVATE_KEY_CACHE_H */
@@ -267,6 +267,35 @@ public:
      * @return Encrypted or decrypted bytes (rely on the current mode).
      */
     virgil::crypto::VirgilByteArray finish();
+
+    /**
+     * @brief Generic cipher update function, that writes result to the given buffer.
+     *
+     * Same as @link update(const VirgilByteArray&) @endlink, but neither input is copied,
+     *     nor output is allocated.
+     *
+     * @param input - data to be encrypted / decrypted.
+     * @param inputSize - input data size.
+     * @param output - buffer for the encrypted / decrypted bytes, MUST NOT overlap with input.
+     * @param outputSize - output buffer size, MUST be at least inputSize + blockSize() if padding is supported,
+     *     and at least inputSize otherwise.
+     * @return Number of bytes written to the output buffer.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if output buffer is too small.
+     */
+    size_t update(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize);
+
+    /**
+     * @brief Cipher finalization method, that writes result to the given buffer.
+     *
+     * Same as @link finish() @endlink, but output is not allocated.
+     *
+     * @param output - buffer for the encrypted / decrypted bytes.
+     * @param outputSize - output buffer size, MUST be at least blockSize() if padding is supported,
+     *     plus authTagLength() if encryption is performed.
+     * @return Number of bytes written to the output buffer.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if output buffer is too small.
+     */
+    size_t finish(unsigned char* output, size_t outputSize);
     ///@}
     /**
      * @name VirgilAsn1Compatible implementation
@@ -172,24 +172,17 @@ public:
     ///@}
 private:
     /**
-     * @brief Logically pad the shorter DER encoding after the last octet with dummy octets,
-     *     that are smaller in value than any normal octet.
-     * @param asn1 - ASN.1 structure that will be padded.
-     * @param finalSize - ASN.1 structure size after padding.
+     * @brief Return dummy octet the shorter DER encoding is logically padded with during comparison,
+     *     it is smaller in value than any normal octet of the given encoding.
      */
-    static virgil::crypto::VirgilByteArray
-            makeComparePadding(const virgil::crypto::VirgilByteArray& asn1, size_t finalSize);
+    static virgil::crypto::VirgilByteArray::value_type
+            comparePaddingByte(const virgil::crypto::VirgilByteArray& asn1);
 
     /**
-     * @brief Perform lexicographic ASN.1 comparison.
+     * @brief Perform lexicographic ASN.1 comparison, the shorter encoding is logically padded.
      */
     static bool compare(const virgil::crypto::VirgilByteArray& first, const virgil::crypto::VirgilByteArray& second);
 
-    /**
-     * @brief Perform ascending lexicographic order on the given set.
-     */
-    static void makeOrderedSet(std::vector<virgil::crypto::VirgilByteArray>& set);
-
 public:
     /**
      * @brief Use default move constructor
@@ -38,6 +38,7 @@
 #define VIRGIL_CRYPTO_VIRGIL_BYTES_DATA_SINK_H
 
 #include "../VirgilDataSink.h"
+#include "../VirgilDataWriter.h"
 
 namespace virgil { namespace crypto { namespace stream {
 
@@ -46,7 +47,8 @@ namespace virgil { namespace crypto { namespace stream {
  *
  * @note This class CAN not be used in wrappers.
  */
-class VirgilBytesDataSink : public virgil::crypto::VirgilDataSink {
+class VirgilBytesDataSink :
+        public virgil::crypto::VirgilDataSink, public virgil::crypto::VirgilDataWriter {
 public:
     /**
      * @brief Creates data sink based on byte array.
@@ -68,6 +70,11 @@ public:
      */
     virtual void write(const virgil::crypto::VirgilByteArray& data);
 
+    /**
+     * @brief Overriding of @link VirgilDataWriter::write() @endlink method.
+     */
+    virtual void write(const unsigned char* data, size_t dataSize);
+
     /**
      * @brief Reset internal state to initial.
      *
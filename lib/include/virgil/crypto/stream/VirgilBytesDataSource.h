@@ -38,16 +38,18 @@
 #define VIRGIL_CRYPTO_VIRGIL_BYTES_DATA_SOURCE_H
 
 #include "../VirgilByteArray.h"
-#include "../VirgilDataSource.h"
+#include "../VirgilDataReader.h"
+#include "../VirgilSeekableDataSource.h"
 
 namespace virgil { namespace crypto { namespace stream {
 
 /**
- * @brief C++ Byte Array implementation of the VirgilDataSource class.
+ * @brief C++ Byte Array implementation of the VirgilSeekableDataSource class.
  *
  * @note This class CAN not be used in wrappers.
  */
-class VirgilBytesDataSource : public virgil::crypto::VirgilDataSource {
+class VirgilBytesDataSource :
+        public virgil::crypto::VirgilSeekableDataSource, public virgil::crypto::VirgilDataReader {
 public:
     /**
      * @brief Creates data sink based on byte array.
@@ -72,6 +74,16 @@ public:
      */
     virtual virgil::crypto::VirgilByteArray read();
 
+    /**
+     * @brief Overriding of @link VirgilDataReader::readInto() @endlink method.
+     */
+    virtual size_t readInto(unsigned char* buffer, size_t bufferSize);
+
+    /**
+     * @brief Overriding of @link VirgilSeekableDataSource::seek() @endlink method.
+     */
+    virtual void seek(size_t position);
+
     /**
      * @brief Reset internal state to initial.
      *
@@ -0,0 +1,106 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SINK_H
+#define VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SINK_H
+
+#include <memory>
+#include <string>
+
+#include "../VirgilByteArray.h"
+#include "../VirgilDataSink.h"
+#include "../VirgilDataWriter.h"
+
+namespace virgil { namespace crypto { namespace stream {
+
+/**
+ * @brief Memory mapped file implementation of the VirgilDataSink class.
+ *
+ * File is extended and mapped by the big windows, that are advised for the sequential access,
+ *     so data is copied directly to the page cache without intermediate stream buffers.
+ *     File is truncated to the size of the written data when sink is closed.
+ *
+ * @note This class CAN not be used in wrappers.
+ * @note Memory mapping is supported on POSIX and Windows platforms only.
+ */
+class VirgilMappedFileDataSink :
+        public virgil::crypto::VirgilDataSink, public virgil::crypto::VirgilDataWriter {
+public:
+    /**
+     * @brief Create (truncate) file for writing.
+     * @param path - path to the file.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if file can not be opened.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if memory mapping is not supported.
+     */
+    explicit VirgilMappedFileDataSink(const std::string& path);
+
+    /**
+     * @brief Close file, if it was not closed yet.
+     * @note Errors are ignored, so call method @link close() @endlink to handle them.
+     */
+    virtual ~VirgilMappedFileDataSink() noexcept;
+
+    /**
+     * @brief Overriding of @link VirgilDataSink::isGood() @endlink method.
+     */
+    virtual bool isGood();
+
+    /**
+     * @brief Overriding of @link VirgilDataSink::write() @endlink method.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if sink is closed or mapping failed.
+     */
+    virtual void write(const virgil::crypto::VirgilByteArray& data);
+
+    /**
+     * @brief Overriding of @link VirgilDataWriter::write() @endlink method.
+     */
+    virtual void write(const unsigned char* data, size_t dataSize);
+
+    /**
+     * @brief Truncate file to the size of the written data, and close it.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if file size can not be changed.
+     */
+    void close();
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SINK_H */
@@ -0,0 +1,114 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SOURCE_H
+#define VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SOURCE_H
+
+#include <memory>
+#include <string>
+
+#include "../VirgilByteArray.h"
+#include "../VirgilDataReader.h"
+#include "../VirgilSeekableDataSource.h"
+
+namespace virgil { namespace crypto { namespace stream {
+
+/**
+ * @brief Memory mapped file implementation of the VirgilSeekableDataSource class.
+ *
+ * File is mapped by the big windows, that are advised for the sequential access,
+ *     so data is copied directly from the page cache without intermediate stream buffers.
+ *
+ * @note This class CAN not be used in wrappers.
+ * @note Memory mapping is supported on POSIX and Windows platforms only.
+ */
+class VirgilMappedFileDataSource :
+        public virgil::crypto::VirgilSeekableDataSource, public virgil::crypto::VirgilDataReader {
+public:
+    /**
+     * @brief Default size of the data that is returned by @link read() @endlink method.
+     */
+    static constexpr size_t kChunkSizeDefault = 1024 * 1024;
+
+    /**
+     * @brief Open file for reading.
+     * @param path - path to the file.
+     * @param chunkSize - size of the data that will be returned by @link read() @endlink method.
+     *                    Note, the real value may be different from the given value, it is only recommendation.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if file can not be opened.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if memory mapping is not supported.
+     */
+    explicit VirgilMappedFileDataSource(const std::string& path, size_t chunkSize = kChunkSizeDefault);
+
+    /**
+     * @brief Polymorphic destructor.
+     */
+    virtual ~VirgilMappedFileDataSource() noexcept;
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::hasData() @endlink method.
+     */
+    virtual bool hasData();
+
+    /**
+     * @brief Overriding of @link VirgilDataSource::read() @endlink method.
+     */
+    virtual virgil::crypto::VirgilByteArray read();
+
+    /**
+     * @brief Overriding of @link VirgilDataReader::readInto() @endlink method.
+     */
+    virtual size_t readInto(unsigned char* buffer, size_t bufferSize);
+
+    /**
+     * @brief Overriding of @link VirgilSeekableDataSource::seek() @endlink method.
+     */
+    virtual void seek(size_t position);
+
+    /**
+     * @brief Return size of the file.
+     */
+    size_t size() const;
+
+private:
+    class Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_VIRGIL_MAPPED_FILE_DATA_SOURCE_H */
@@ -40,6 +40,7 @@
 #include <ostream>
 
 #include "../VirgilDataSink.h"
+#include "../VirgilDataWriter.h"
 
 namespace virgil { namespace crypto { namespace stream {
 
@@ -48,7 +49,8 @@ namespace virgil { namespace crypto { namespace stream {
  *
  * @note This class CAN not be used in wrappers.
  */
-class VirgilStreamDataSink : public virgil::crypto::VirgilDataSink {
+class VirgilStreamDataSink :
+        public virgil::crypto::VirgilDataSink, public virgil::crypto::VirgilDataWriter {
 public:
     /**
      * @brief Creates data sink based on std::ostream object.
@@ -70,6 +72,11 @@ public:
      */
     virtual void write(const virgil::crypto::VirgilByteArray& data);
 
+    /**
+     * @brief Overriding of @link VirgilDataWriter::write() @endlink method.
+     */
+    virtual void write(const unsigned char* data, size_t dataSize);
+
 private:
     std::ostream& out_;
 };
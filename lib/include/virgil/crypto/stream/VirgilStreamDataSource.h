@@ -40,16 +40,18 @@
 #include <istream>
 
 #include "../VirgilByteArray.h"
-#include "../VirgilDataSource.h"
+#include "../VirgilDataReader.h"
+#include "../VirgilSeekableDataSource.h"
 
 namespace virgil { namespace crypto { namespace stream {
 
 /**
- * @brief C++ stream implementation of the VirgilDataSource class.
+ * @brief C++ stream implementation of the VirgilSeekableDataSource class.
  *
  * @note This class CAN not be used in wrappers.
  */
-class VirgilStreamDataSource : public virgil::crypto::VirgilDataSource {
+class VirgilStreamDataSource :
+        public virgil::crypto::VirgilSeekableDataSource, public virgil::crypto::VirgilDataReader {
 public:
     /**
      * @brief Creates data sink based on std::istream object.
@@ -74,6 +76,17 @@ public:
      */
     virtual virgil::crypto::VirgilByteArray read();
 
+    /**
+     * @brief Overriding of @link VirgilDataReader::readInto() @endlink method.
+     */
+    virtual size_t readInto(unsigned char* buffer, size_t bufferSize);
+
+    /**
+     * @brief Overriding of @link VirgilSeekableDataSource::seek() @endlink method.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if stream does not support seeking.
+     */
+    virtual void seek(size_t position);
+
 private:
     std::istream& in_;
     size_t chunkSize_;
@@ -36,6 +36,7 @@
 
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
@@ -44,11 +45,13 @@
 #include <mbedtls/asn1write.h>
 
 #include "utils.h"
+#include "VirgilScratchArena.h"
 #include <virgil/crypto/foundation/VirgilSystemCryptoError.h>
 
 using virgil::crypto::VirgilByteArray;
 
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
+using virgil::crypto::foundation::internal::VirgilScratchArena;
 
 
 static const size_t kBufLenDefault = 128;
@@ -227,14 +230,18 @@ size_t VirgilAsn1Writer::writeSet(const std::vector<VirgilByteArray>& set) {
     }
     ensureBufferEnough(kAsn1TagValueSize + kAsn1LengthValueSize + setLength);
 
-    std::vector<VirgilByteArray> orderedSet(set);
-    makeOrderedSet(orderedSet);
+    VirgilScratchArena::Scope scratch;
+    auto orderedSet = scratch.allocateArray<const VirgilByteArray*>(set.size());
+    std::transform(set.cbegin(), set.cend(), orderedSet, [](const VirgilByteArray& item) { return &item; });
+    std::sort(orderedSet, orderedSet + set.size(), [](const VirgilByteArray* first, const VirgilByteArray* second) {
+        return VirgilAsn1Writer::compare(*first, *second);
+    });
     RETURN_POINTER_DIFF_AFTER_INVOCATION(p_,
             {
-                for (std::vector<VirgilByteArray>::const_reverse_iterator it = orderedSet.rbegin();
-                     it != orderedSet.rend(); ++it) {
+                for (size_t i = set.size(); i > 0; --i) {
+                    const VirgilByteArray& item = *orderedSet[i - 1];
                     system_crypto_handler(
-                            mbedtls_asn1_write_raw_buffer(&p_, start_, it->data(), it->size())
+                            mbedtls_asn1_write_raw_buffer(&p_, start_, item.data(), item.size())
                     );
                 }
                 system_crypto_handler(
@@ -247,36 +254,33 @@ size_t VirgilAsn1Writer::writeSet(const std::vector<VirgilByteArray>& set) {
     );
 }
 
-VirgilByteArray VirgilAsn1Writer::makeComparePadding(const VirgilByteArray& asn1, size_t finalSize) {
-    VirgilByteArray result = asn1;
-    if (result.size() >= finalSize) {
-        return result;
+VirgilByteArray::value_type VirgilAsn1Writer::comparePaddingByte(const VirgilByteArray& asn1) {
+    if (asn1.empty()) {
+        return 0x00;
     }
-    VirgilByteArray::value_type smallestByte = 0x00;
-    if (result.size() > 0) {
-        smallestByte = *std::min_element(result.begin(), result.end());
-        if (smallestByte != 0x00) {
-            --smallestByte;
-        }
-    }
-    result.resize(finalSize, smallestByte);
-    return result;
+    const VirgilByteArray::value_type smallestByte = *std::min_element(asn1.begin(), asn1.end());
+    return smallestByte != 0x00 ? smallestByte - 1 : smallestByte;
 }
 
 bool VirgilAsn1Writer::compare(const VirgilByteArray& first, const VirgilByteArray& second) {
+    const size_t commonSize = std::min(first.size(), second.size());
+    const auto mismatch = std::mismatch(first.begin(), first.begin() + commonSize, second.begin());
+    if (mismatch.first != first.begin() + commonSize) {
+        return *mismatch.first < *mismatch.second;
+    }
     if (first.size() > second.size()) {
-        VirgilByteArray paddedSecond = makeComparePadding(second, first.size());
-        return std::lexicographical_compare(first.begin(), first.end(), paddedSecond.begin(), paddedSecond.end());
-    } else if (second.size() > first.size()) {
-        VirgilByteArray paddedFirst = makeComparePadding(first, second.size());
-        return std::lexicographical_compare(paddedFirst.begin(), paddedFirst.end(), second.begin(), second.end());
-    } else {
-        return std::lexicographical_compare(first.begin(), first.end(), second.begin(), second.end());
+        const auto padding = comparePaddingByte(second);
+        const auto differs = std::find_if(first.begin() + commonSize, first.end(),
+                [padding](VirgilByteArray::value_type byte) { return byte != padding; });
+        return differs != first.end() && *differs < padding;
     }
-}
-
-void VirgilAsn1Writer::makeOrderedSet(std::vector<VirgilByteArray>& set) {
-    std::sort(set.begin(), set.end(), VirgilAsn1Writer::compare);
+    if (second.size() > first.size()) {
+        const auto padding = comparePaddingByte(first);
+        const auto differs = std::find_if(second.begin() + commonSize, second.end(),
+                [padding](VirgilByteArray::value_type byte) { return byte != padding; });
+        return differs != second.end() && padding < *differs;
+    }
+    return false;
 }
 
 void VirgilAsn1Writer::checkState() {
@@ -43,7 +43,6 @@
 #include <mbedtls/pk.h>
 #include <mbedtls/oid.h>
 #include <mbedtls/base64.h>
-#include <mbedtls/entropy.h>
 #include <mbedtls/ctr_drbg.h>
 #include <mbedtls/ecdh.h>
 #include <mbedtls/asn1write.h>
@@ -53,6 +52,7 @@
 #include <tinyformat/tinyformat.h>
 
 #include <virgil/crypto/VirgilByteArrayUtils.h>
+#include <virgil/crypto/foundation/VirgilPrivateKeyCache.h>
 #include <virgil/crypto/foundation/VirgilSystemCryptoError.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
@@ -60,18 +60,23 @@
 
 #include "utils.h"
 #include "mbedtls_context.h"
+#include "VirgilRandomPool.h"
+#include "VirgilScratchArena.h"
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilKeyPair;
 
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
+using virgil::crypto::foundation::VirgilPrivateKeyCache;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::internal::VirgilAsn1Alg;
 
 using virgil::crypto::foundation::internal::mbedtls_context;
 using virgil::crypto::foundation::internal::mbedtls_context_policy;
+using virgil::crypto::foundation::internal::VirgilRandomPool;
+using virgil::crypto::foundation::internal::VirgilScratchArena;
 
 #include <cstdio>
 
@@ -123,7 +128,7 @@ namespace virgil { namespace crypto { namespace foundation { namespace internal
  */
 void gen_key_pair(
         mbedtls_context<mbedtls_pk_context>& pk_ctx,
-        mbedtls_context<mbedtls_ctr_drbg_context>& ctr_drbg_ctx, unsigned int rsa_size, int rsa_exponent,
+        mbedtls_ctr_drbg_context* ctr_drbg_ctx, unsigned int rsa_size, int rsa_exponent,
         mbedtls_ecp_group_id ecp_group_id, mbedtls_fast_ec_type_t fast_ec_type) {
 
     if (rsa_size > 0) {
@@ -131,14 +136,14 @@ void gen_key_pair(
         system_crypto_handler(
                 mbedtls_rsa_gen_key(
                         mbedtls_pk_rsa(*(pk_ctx.get())), mbedtls_ctr_drbg_random,
-                        ctr_drbg_ctx.get(), rsa_size, rsa_exponent),
+                        ctr_drbg_ctx, rsa_size, rsa_exponent),
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
     } else if (ecp_group_id != MBEDTLS_ECP_DP_NONE) {
         pk_ctx.clear().setup(MBEDTLS_PK_ECKEY);
         system_crypto_handler(
                 mbedtls_ecp_gen_key(
                         ecp_group_id, mbedtls_pk_ec(*(pk_ctx.get())),
-                        mbedtls_ctr_drbg_random, ctr_drbg_ctx.get()),
+                        mbedtls_ctr_drbg_random, ctr_drbg_ctx),
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
     } else if (fast_ec_type != MBEDTLS_FAST_EC_NONE) {
         pk_ctx.clear().setup(mbedtls_pk_from_fast_ec_type(fast_ec_type));
@@ -152,7 +157,7 @@ void gen_key_pair(
         system_crypto_handler(
                 mbedtls_fast_ec_gen_key(
                         mbedtls_pk_fast_ec(*(pk_ctx.get())),
-                        mbedtls_ctr_drbg_random, ctr_drbg_ctx.get()),
+                        mbedtls_ctr_drbg_random, ctr_drbg_ctx),
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); });
     }
 }
@@ -162,17 +167,19 @@ VirgilByteArray processEncryptionDecryption(
         EncDecFunc processEncryptionOrDecryption,
         mbedtls_pk_context* pk_ctx, mbedtls_ctr_drbg_context* ctr_drbg_ctx, const VirgilByteArray& in) {
 
-    VirgilByteArray result(1024);
+    constexpr size_t kResultSizeMax = 1024;
+
+    VirgilScratchArena::Scope scratch;
+    auto result = scratch.allocate(kResultSizeMax);
     size_t resultLen = 0;
 
     system_crypto_handler(
             processEncryptionOrDecryption(
-                    pk_ctx, in.data(), in.size(), result.data(), &resultLen, result.size(),
+                    pk_ctx, in.data(), in.size(), result, &resultLen, kResultSizeMax,
                     mbedtls_ctr_drbg_random, ctr_drbg_ctx),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::UnsupportedAlgorithm)); }
                          );
-    result.resize(resultLen);
-    return result;
+    return VirgilByteArray(result, result + resultLen);
 }
 
 static VirgilByteArray fixKey(const VirgilByteArray& key) {
@@ -223,8 +230,7 @@ mbedtls_context<mbedtls_ctr_drbg_context> create_deterministic_rng_ctx(const Vir
 class VirgilAsymmetricCipher::Impl {
 public:
     internal::mbedtls_context <mbedtls_pk_context> pk_ctx;
-    mbedtls_context<mbedtls_entropy_context> entropy_ctx;
-    mbedtls_context<mbedtls_ctr_drbg_context> ctr_drbg_ctx;
+    VirgilRandomPool::Lease ctr_drbg_ctx;
 };
 
 VirgilAsymmetricCipher::VirgilAsymmetricCipher(VirgilAsymmetricCipher&& other) noexcept = default;
@@ -234,8 +240,7 @@ VirgilAsymmetricCipher& VirgilAsymmetricCipher::operator=(VirgilAsymmetricCipher
 VirgilAsymmetricCipher::~VirgilAsymmetricCipher() noexcept = default;
 
 VirgilAsymmetricCipher::VirgilAsymmetricCipher() : impl_(std::make_unique<Impl>()) {
-    constexpr const char pers[] = "VirgilAsymmetricCipher";
-    impl_->ctr_drbg_ctx.setup(mbedtls_entropy_func, impl_->entropy_ctx.get(), pers);
+    impl_->ctr_drbg_ctx = VirgilRandomPool::acquire();
 }
 
 size_t VirgilAsymmetricCipher::keySize() const {
@@ -298,6 +303,18 @@ bool VirgilAsymmetricCipher::isPrivateKeyEncrypted(const VirgilByteArray& privat
 void VirgilAsymmetricCipher::setPrivateKey(const VirgilByteArray& key, const VirgilByteArray& pwd) {
     const VirgilByteArray fixedKey = internal::fixKey(key);
     impl_->pk_ctx.clear();
+    if (!pwd.empty()) {
+        VirgilByteArray cachedKey;
+        if (VirgilPrivateKeyCache::find(fixedKey, pwd, cachedKey)) {
+            const int result = mbedtls_pk_parse_key(
+                    impl_->pk_ctx.get(), cachedKey.data(), cachedKey.size(), nullptr, 0);
+            bytes_zeroize(cachedKey);
+            if (result == 0) {
+                return;
+            }
+            impl_->pk_ctx.clear();
+        }
+    }
     system_crypto_handler(
             mbedtls_pk_parse_key(impl_->pk_ctx.get(), fixedKey.data(), fixedKey.size(), pwd.data(), pwd.size()),
             [](int error) {
@@ -309,6 +326,9 @@ void VirgilAsymmetricCipher::setPrivateKey(const VirgilByteArray& key, const Vir
                             std::throw_with_nested(make_error(VirgilCryptoError::InvalidPrivateKey));
                     }
             });
+    if (!pwd.empty() && VirgilPrivateKeyCache::isEnabled()) {
+        VirgilPrivateKeyCache::store(fixedKey, pwd, exportPrivateKeyToDER(VirgilByteArray()));
+    }
 }
 
 void VirgilAsymmetricCipher::setPublicKey(const VirgilByteArray& key) {
@@ -326,7 +346,7 @@ void VirgilAsymmetricCipher::genKeyPair(VirgilKeyPair::Type type) {
     mbedtls_ecp_group_id ecTypeId = MBEDTLS_ECP_DP_NONE;
     mbedtls_fast_ec_type_t fastEcType = MBEDTLS_FAST_EC_NONE;
     internal::key_type_set_params(type, &rsaSize, &ecTypeId, &fastEcType);
-    internal::gen_key_pair(impl_->pk_ctx, impl_->ctr_drbg_ctx, rsaSize, 65537, ecTypeId, fastEcType);
+    internal::gen_key_pair(impl_->pk_ctx, impl_->ctr_drbg_ctx.get(), rsaSize, 65537, ecTypeId, fastEcType);
 }
 
 void VirgilAsymmetricCipher::genKeyPairFromKeyMaterial(VirgilKeyPair::Type type, const VirgilByteArray& keyMaterial) {
@@ -343,7 +363,7 @@ void VirgilAsymmetricCipher::genKeyPairFromKeyMaterial(VirgilKeyPair::Type type,
     mbedtls_fast_ec_type_t fastEcType = MBEDTLS_FAST_EC_NONE;
     internal::key_type_set_params(type, &rsaSize, &ecTypeId, &fastEcType);
     auto deterministic_drbg_ctx = internal::create_deterministic_rng_ctx(keyMaterial);
-    internal::gen_key_pair(impl_->pk_ctx, deterministic_drbg_ctx, rsaSize, 65537, ecTypeId, fastEcType);
+    internal::gen_key_pair(impl_->pk_ctx, deterministic_drbg_ctx.get(), rsaSize, 65537, ecTypeId, fastEcType);
 }
 
 void VirgilAsymmetricCipher::genKeyPairFrom(const VirgilAsymmetricCipher& other) {
@@ -352,18 +372,18 @@ void VirgilAsymmetricCipher::genKeyPairFrom(const VirgilAsymmetricCipher& other)
 
     if (mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_RSA)) {
         internal::gen_key_pair(
-                impl_->pk_ctx, impl_->ctr_drbg_ctx,
+                impl_->pk_ctx, impl_->ctr_drbg_ctx.get(),
                 mbedtls_pk_get_bitlen(other.impl_->pk_ctx.get()), 65537,
                 MBEDTLS_ECP_DP_NONE, MBEDTLS_FAST_EC_NONE);
     } else if (mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_ECKEY)) {
         internal::gen_key_pair(
-                impl_->pk_ctx, impl_->ctr_drbg_ctx,
+                impl_->pk_ctx, impl_->ctr_drbg_ctx.get(),
                 0, 0, mbedtls_pk_ec(*(other.impl_->pk_ctx.get()))->grp.id,
                 MBEDTLS_FAST_EC_NONE);
     } else if (mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_X25519) ||
                mbedtls_pk_can_do(other.impl_->pk_ctx.get(), MBEDTLS_PK_ED25519)) {
         internal::gen_key_pair(
-                impl_->pk_ctx, impl_->ctr_drbg_ctx,
+                impl_->pk_ctx, impl_->ctr_drbg_ctx.get(),
                 0, 0, MBEDTLS_ECP_DP_NONE,
                 mbedtls_fast_ec_get_type(mbedtls_pk_fast_ec(*(other.impl_->pk_ctx.get()))->info));
     } else {
@@ -699,7 +719,7 @@ size_t VirgilAsymmetricCipher::calculateExportedPrivateKeySizeMaxPEM(size_t encr
 
 VirgilByteArray VirgilAsymmetricCipher::generateParametersPBES() const {
     return VirgilAsn1Alg::buildPKCS5(
-            internal::randomize(impl_->ctr_drbg_ctx, 16), internal::randomize(impl_->ctr_drbg_ctx, 3072, 8192));
+            internal::randomize(impl_->ctr_drbg_ctx.get(), 16), internal::randomize(impl_->ctr_drbg_ctx.get(), 3072, 8192));
 }
 
 VirgilByteArray VirgilAsymmetricCipher::adjustBufferWithDER(const VirgilByteArray& buffer, int size) {
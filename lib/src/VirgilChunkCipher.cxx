@@ -36,21 +36,28 @@
 
 #include <virgil/crypto/VirgilChunkCipher.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <vector>
 
-#include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilCryptoError.h>
+#include <virgil/crypto/VirgilCryptoException.h>
 #include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
 #include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
 
 #include "ScopeGuard.h"
+#include "VirgilDataIO.h"
+#include "VirgilParallel.h"
+#include "VirgilStagingBuffer.h"
 
 using virgil::crypto::VirgilByteArray;
-using virgil::crypto::VirgilByteArrayUtils;
 using virgil::crypto::VirgilChunkCipher;
 using virgil::crypto::VirgilDataSource;
 using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilDataReader;
+using virgil::crypto::VirgilDataWriter;
+using virgil::crypto::VirgilSeekableDataSource;
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 
@@ -59,6 +66,8 @@ using virgil::crypto::foundation::VirgilSymmetricCipher;
  */
 ///@{
 static const char* const kCustomParameterKey_ChunkSize = "chunkSize";
+static const char* const kCustomParameterKey_ChunkNonce = "chunkNonce";
+static const int kChunkNonce_Indexed = 1;
 ///@}
 
 namespace virgil { namespace crypto { namespace internal {
@@ -105,8 +114,71 @@ static VirgilByteArray make_unique_nonce(const VirgilByteArray& nonce, const Vir
     return xor_octets(nonce, counter);
 }
 
+static VirgilByteArray make_chunk_nonce(const VirgilByteArray& nonce, size_t chunkIndex) {
+    VirgilByteArray result(nonce);
+    for (VirgilByteArray::reverse_iterator it = result.rbegin();
+         it != result.rend() && chunkIndex != 0; ++it, chunkIndex >>= 8) {
+        *it ^= static_cast<unsigned char>(chunkIndex & 0xFF);
+    }
+    return result;
+}
+
+/**
+ * @brief Encrypt / decrypt chunk to the given buffer.
+ * @note Buffer storage is reused, so it is not reallocated for the chunks of the same size.
+ */
+static void process_chunk(
+        VirgilSymmetricCipher& symmetricCipher, const VirgilByteArray& nonce,
+        const unsigned char* chunk, size_t chunkSize, VirgilByteArray& processedChunk) {
+    symmetricCipher.setIV(nonce);
+    symmetricCipher.reset();
+    processedChunk.resize(chunkSize + symmetricCipher.blockSize() + symmetricCipher.authTagLength());
+    size_t processedChunkSize = symmetricCipher.update(chunk, chunkSize, processedChunk.data(), processedChunk.size());
+    processedChunkSize += symmetricCipher.finish(
+            processedChunk.data() + processedChunkSize, processedChunk.size() - processedChunkSize);
+    processedChunk.resize(processedChunkSize);
+}
+
+/**
+ * @brief Read data from the source until buffer contains at least dataSize bytes, or source is exhausted.
+ * @note If reader is given, data is read directly to the buffer.
+ */
+static void read_data(
+        VirgilDataSource& source, VirgilDataReader* reader, VirgilStagingBuffer& data, size_t dataSize) {
+    while (source.hasData() && data.size() < dataSize) {
+        if (reader != nullptr) {
+            data.append(*reader, dataSize - data.size());
+        } else {
+            data.append(source.read());
+        }
+    }
+}
+
+/**
+ * @brief Write data to the sink, or directly to the writer if it is given.
+ */
+static void write_data(
+        VirgilDataSink& sink, VirgilDataWriter* writer, const unsigned char* data, size_t dataSize) {
+    if (writer != nullptr) {
+        VirgilDataWriter::safeWrite(*writer, data, dataSize);
+    } else {
+        VirgilDataSink::safeWrite(sink, VirgilByteArray(data, data + dataSize));
+    }
+}
+
 }}}
 
+void VirgilChunkCipher::setChunkProcessingThreads(size_t threadsNum) {
+    if (threadsNum == 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Number of threads can not be zero.");
+    }
+    chunkProcessingThreads_ = threadsNum;
+}
+
+size_t VirgilChunkCipher::getChunkProcessingThreads() const {
+    return chunkProcessingThreads_;
+}
+
 void VirgilChunkCipher::encrypt(
         VirgilDataSource& source, VirgilDataSink& sink, bool embedContentInfo, size_t preferredChunkSize) {
 
@@ -122,6 +194,7 @@ void VirgilChunkCipher::encrypt(
             getSymmetricCipher().blockSize(), getSymmetricCipher().isSupportPadding());
 
     storeChunkSize(actualChunkSize);
+    customParams().setInteger(str2bytes(kCustomParameterKey_ChunkNonce), kChunkNonce_Indexed);
 
     if (embedContentInfo) {
         VirgilDataSink::safeWrite(sink, getContentInfo());
@@ -155,6 +228,33 @@ void VirgilChunkCipher::decryptWithPassword(
     process(source, sink, 0);
 }
 
+void VirgilChunkCipher::decryptRangeWithKey(
+        VirgilSeekableDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+        const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+        const VirgilByteArray& privateKeyPassword) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    initDecryptionWithKey(recipientId, privateKey, privateKeyPassword);
+
+    processRange(source, sink, offset, length);
+}
+
+void VirgilChunkCipher::decryptRangeWithPassword(
+        VirgilSeekableDataSource& source, VirgilDataSink& sink, size_t offset, size_t length,
+        const VirgilByteArray& pwd) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    initDecryptionWithPassword(pwd);
+
+    processRange(source, sink, offset, length);
+}
+
 void VirgilChunkCipher::storeChunkSize(size_t chunkSize) {
     if (chunkSize > std::numeric_limits<int>::max()) {
         throw make_error(VirgilCryptoError::InvalidArgument, "Chunk size is too big.");
@@ -171,44 +271,196 @@ size_t VirgilChunkCipher::retrieveChunkSize() const {
 }
 
 
+bool VirgilChunkCipher::hasIndexedChunkNonce() const {
+    try {
+        return customParams().getInteger(str2bytes(kCustomParameterKey_ChunkNonce)) == kChunkNonce_Indexed;
+    } catch (const VirgilCryptoException&) {
+        return false;
+    }
+}
+
 void VirgilChunkCipher::process(VirgilDataSource& source, VirgilDataSink& sink, size_t actualChunkSize) {
 
-    VirgilByteArray data;
+    internal::VirgilStagingBuffer data;
 
-    // Collect until Content Info fully read.
+    // Collect until Content Info fully read, data that follows it is not copied.
     while (source.hasData() && data.empty()) {
         VirgilByteArray chunk = source.read();
-        data = isReadyForEncryption() ? chunk : filterAndSetupContentInfo(chunk, !source.hasData());
+        size_t payloadOffset = 0;
+        if (!isReadyForEncryption()) {
+            VirgilByteArray heldData;
+            payloadOffset = filterAndSetupContentInfo(chunk.data(), chunk.size(), !source.hasData(), heldData);
+            data.append(std::move(heldData));
+        }
+        if (data.empty()) {
+            data.append(std::move(chunk));
+            data.consume(payloadOffset);
+        } else {
+            data.append(VirgilByteArray(chunk.cbegin() + payloadOffset, chunk.cend()));
+        }
     }
 
-    auto &symmetricCipher = getSymmetricCipher();
+    auto& symmetricCipher = getSymmetricCipher();
 
     // Adjust chunk size for decryption
     if (isReadyForDecryption()) {
         actualChunkSize = internal::adjustDecryptionChunkSize(retrieveChunkSize(),
             symmetricCipher.blockSize(), symmetricCipher.isSupportPadding(),
             symmetricCipher.authTagLength());
+
+        if (!hasIndexedChunkNonce()) {
+            processLegacy(source, sink, actualChunkSize, data.pop(data.size()));
+            return;
+        }
     }
 
+    const VirgilByteArray nonce = symmetricCipher.iv();
+    const size_t batchSize = chunkProcessingThreads_ > 1 ? chunkProcessingThreads_ * kChunksPerThread : 1;
+    auto reader = internal::as_data_reader(source);
+    auto writer = internal::as_data_writer(sink);
+
+    std::vector<VirgilByteArray> processedChunks;
+    std::vector<VirgilSymmetricCipher> chunkCiphers;
+    size_t chunkIndex = 0;
+
+    do {
+        // Collect data for the batch of full chunks
+        internal::read_data(source, reader, data, actualChunkSize * batchSize);
+        // Define chunks within collected data, the last chunk can be partial
+        const size_t chunksNum = std::min(batchSize, source.hasData() ?
+                data.size() / actualChunkSize : (data.size() + actualChunkSize - 1) / actualChunkSize);
+        const auto chunkSize = [&](size_t index) {
+            return std::min(actualChunkSize, data.size() - index * actualChunkSize);
+        };
+        // Process (encrypt/decrypt), buffers of the processed chunks are reused for the next batches
+        if (processedChunks.size() < chunksNum) {
+            processedChunks.resize(chunksNum);
+        }
+        if (chunksNum > 1) {
+            // Ciphers are cloned within calling thread and then are reused for the next batches
+            while (chunkCiphers.size() < chunksNum) {
+                chunkCiphers.push_back(cloneSymmetricCipher());
+            }
+            internal::parallel_for(chunksNum, chunkProcessingThreads_, [&](size_t index) {
+                internal::process_chunk(chunkCiphers[index],
+                        internal::make_chunk_nonce(nonce, chunkIndex + index),
+                        data.data() + index * actualChunkSize, chunkSize(index), processedChunks[index]);
+            });
+        } else if (chunksNum == 1) {
+            internal::process_chunk(symmetricCipher,
+                    internal::make_chunk_nonce(nonce, chunkIndex), data.data(), chunkSize(0), processedChunks.front());
+        }
+        // Write processed chunks in the original order
+        for (size_t index = 0; index < chunksNum; ++index) {
+            internal::write_data(sink, writer, processedChunks[index].data(), processedChunks[index].size());
+        }
+        data.consume(chunksNum * actualChunkSize);
+        chunkIndex += chunksNum;
+    } while (source.hasData() || !data.empty());
+}
+
+void VirgilChunkCipher::processLegacy(
+        VirgilDataSource& source, VirgilDataSink& sink, size_t actualChunkSize, VirgilByteArray contentData) {
+
+    auto& symmetricCipher = getSymmetricCipher();
+
+    internal::VirgilStagingBuffer data(std::move(contentData));
+    VirgilByteArray processedChunk;
+    auto reader = internal::as_data_reader(source);
+    auto writer = internal::as_data_writer(sink);
+
     do {
         VirgilByteArray nonceCounter(symmetricCipher.ivSize());
         const VirgilByteArray nonce = symmetricCipher.iv();
 
         // Collect data for full chunk
-        while (source.hasData() && data.size() < actualChunkSize) {
-            VirgilByteArrayUtils::append(data, source.read());
-        }
+        internal::read_data(source, reader, data, actualChunkSize);
         // Process (encrypt/decrypt)
         while (data.size() >= actualChunkSize || (!data.empty() && !source.hasData())) {
             // Reconfigure symmetric cipher
-            symmetricCipher.setIV(internal::make_unique_nonce(nonce, nonceCounter));
-            symmetricCipher.reset();
-            const VirgilByteArray chunk = VirgilByteArrayUtils::popBytes(data, actualChunkSize);
-            VirgilByteArray processedChunk;
-            VirgilByteArrayUtils::append(processedChunk, symmetricCipher.update(chunk));
-            VirgilByteArrayUtils::append(processedChunk, symmetricCipher.finish());
+            const size_t chunkSize = std::min(actualChunkSize, data.size());
+            internal::process_chunk(symmetricCipher,
+                    internal::make_unique_nonce(nonce, nonceCounter), data.data(), chunkSize, processedChunk);
+            data.consume(chunkSize);
             internal::increment_octets(nonceCounter);
-            VirgilDataSink::safeWrite(sink, processedChunk);
+            internal::write_data(sink, writer, processedChunk.data(), processedChunk.size());
         }
     } while (source.hasData());
 }
+
+void VirgilChunkCipher::processRange(
+        VirgilSeekableDataSource& source, VirgilDataSink& sink, size_t offset, size_t length) {
+
+    VirgilByteArray heldData;
+    size_t readSize = 0;
+    size_t payloadSize = 0;
+
+    // Read until Content Info fully read, only its position is needed.
+    source.seek(0);
+    while (source.hasData() && !isReadyForDecryption()) {
+        const VirgilByteArray chunk = source.read();
+        readSize += chunk.size();
+        const size_t chunkPayloadOffset =
+                filterAndSetupContentInfo(chunk.data(), chunk.size(), !source.hasData(), heldData);
+        payloadSize = heldData.size() + chunk.size() - chunkPayloadOffset;
+    }
+
+    if (!isReadyForDecryption()) {
+        filterAndSetupContentInfo(nullptr, 0, true, heldData);
+        payloadSize = heldData.size();
+    }
+
+    if (!hasIndexedChunkNonce()) {
+        throw make_error(VirgilCryptoError::InvalidFormat,
+                "Random access is not supported for the data encrypted by the previous library versions.");
+    }
+
+    auto& symmetricCipher = getSymmetricCipher();
+
+    const size_t payloadOffset = readSize - payloadSize;
+    const size_t plainChunkSize = retrieveChunkSize();
+    const size_t encryptedChunkSize = internal::adjustDecryptionChunkSize(plainChunkSize,
+            symmetricCipher.blockSize(), symmetricCipher.isSupportPadding(),
+            symmetricCipher.authTagLength());
+
+    if (length == 0 || plainChunkSize == 0) {
+        return;
+    }
+
+    const VirgilByteArray nonce = symmetricCipher.iv();
+    const size_t rangeEnd = length > std::numeric_limits<size_t>::max() - offset ?
+            std::numeric_limits<size_t>::max() : offset + length;
+
+    size_t chunkIndex = offset / plainChunkSize;
+    const size_t lastChunkIndex = (rangeEnd - 1) / plainChunkSize;
+
+    internal::VirgilStagingBuffer data;
+    VirgilByteArray chunk;
+    auto reader = internal::as_data_reader(source);
+    auto writer = internal::as_data_writer(sink);
+    source.seek(payloadOffset + chunkIndex * encryptedChunkSize);
+
+    for (; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+        // Collect data for full chunk
+        internal::read_data(source, reader, data, encryptedChunkSize);
+        if (data.empty()) {
+            break;
+        }
+        // Decrypt and cut requested part
+        const size_t encryptedChunkPartSize = std::min(encryptedChunkSize, data.size());
+        internal::process_chunk(symmetricCipher,
+                internal::make_chunk_nonce(nonce, chunkIndex), data.data(), encryptedChunkPartSize, chunk);
+        data.consume(encryptedChunkPartSize);
+
+        const size_t chunkOffset = chunkIndex * plainChunkSize;
+        const size_t chunkBegin = offset > chunkOffset ? offset - chunkOffset : 0;
+        const size_t chunkEnd = std::min(chunk.size(), rangeEnd - chunkOffset);
+        if (chunkBegin < chunkEnd) {
+            internal::write_data(sink, writer, chunk.data() + chunkBegin, chunkEnd - chunkBegin);
+        }
+        if (chunk.size() < plainChunkSize) {
+            // It was the last chunk.
+            break;
+        }
+    }
+}
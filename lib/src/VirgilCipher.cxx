@@ -36,6 +36,10 @@
 
 #include <virgil/crypto/VirgilCipher.h>
 
+#include <algorithm>
+
+#include <mbedtls/cipher.h>
+
 #include <virgil/crypto/VirgilCryptoError.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
@@ -46,65 +50,174 @@ using virgil::crypto::VirgilCipher;
 using virgil::crypto::VirgilCryptoError;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::VirgilPrivateKeyHandle;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 
 using virgil::crypto::make_error;
 
 VirgilByteArray VirgilCipher::encrypt(const VirgilByteArray& data, bool embedContentInfo) {
+    return encrypt(data.data(), data.size(), embedContentInfo);
+}
 
-    auto disposer = ScopeGuard([this]() {
-        clear();
-    });
+VirgilByteArray VirgilCipher::decryptWithKey(
+        const VirgilByteArray& encryptedData,
+        const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+        const VirgilByteArray& privateKeyPassword) {
 
-    initEncryption();
+    return decryptWithKey(encryptedData.data(), encryptedData.size(), recipientId, privateKey, privateKeyPassword);
+}
 
-    VirgilByteArray encryptedData;
+VirgilByteArray VirgilCipher::decryptWithKey(
+        const VirgilByteArray& encryptedData,
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
 
-    buildContentInfo();
+    return decryptWithKey(encryptedData.data(), encryptedData.size(), recipientId, privateKey);
+}
 
-    if (embedContentInfo) {
-        VirgilByteArray contentInfo = getContentInfo();
-        encryptedData.swap(contentInfo);
-    }
+VirgilByteArray VirgilCipher::decryptWithPassword(const VirgilByteArray& encryptedData, const VirgilByteArray& pwd) {
 
-    VirgilByteArrayUtils::append(encryptedData, getSymmetricCipher().update(data));
-    VirgilByteArrayUtils::append(encryptedData, getSymmetricCipher().finish());
+    return decryptWithPassword(encryptedData.data(), encryptedData.size(), pwd);
+}
+
+VirgilByteArray VirgilCipher::encrypt(const unsigned char* data, size_t dataSize, bool embedContentInfo) {
 
+    // Every call uses new content encryption key.
+    clear();
+
+    VirgilByteArray encryptedData(encryptedSize(dataSize, embedContentInfo));
+    encryptedData.resize(encryptInto(data, dataSize, encryptedData.data(), encryptedData.size(), embedContentInfo));
     return encryptedData;
 }
 
 VirgilByteArray VirgilCipher::decryptWithKey(
-        const VirgilByteArray& encryptedData,
+        const unsigned char* encryptedData, size_t encryptedDataSize,
+        const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
+        const VirgilByteArray& privateKeyPassword) {
+
+    VirgilByteArray decryptedData(encryptedDataSize + MBEDTLS_MAX_BLOCK_LENGTH);
+    decryptedData.resize(decryptInto(encryptedData, encryptedDataSize, decryptedData.data(), decryptedData.size(),
+            recipientId, privateKey, privateKeyPassword));
+    return decryptedData;
+}
+
+VirgilByteArray VirgilCipher::decryptWithKey(
+        const unsigned char* encryptedData, size_t encryptedDataSize,
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
+
+    VirgilByteArray decryptedData(encryptedDataSize + MBEDTLS_MAX_BLOCK_LENGTH);
+    decryptedData.resize(decryptInto(encryptedData, encryptedDataSize, decryptedData.data(), decryptedData.size(),
+            recipientId, privateKey));
+    return decryptedData;
+}
+
+VirgilByteArray VirgilCipher::decryptWithPassword(
+        const unsigned char* encryptedData, size_t encryptedDataSize, const VirgilByteArray& pwd) {
+
+    VirgilByteArray decryptedData(encryptedDataSize + MBEDTLS_MAX_BLOCK_LENGTH);
+    decryptedData.resize(decryptInto(encryptedData, encryptedDataSize, decryptedData.data(), decryptedData.size(),
+            pwd));
+    return decryptedData;
+}
+
+size_t VirgilCipher::encryptedSize(size_t dataSize, bool embedContentInfo) {
+
+    if (!isReadyForEncryption()) {
+        initEncryption();
+        buildContentInfo();
+    }
+
+    return (embedContentInfo ? getContentInfo().size() : 0) + encryptedPayloadSize(dataSize);
+}
+
+size_t VirgilCipher::encryptInto(
+        const unsigned char* data, size_t dataSize, unsigned char* output, size_t outputSize,
+        bool embedContentInfo) {
+
+    if (!isReadyForEncryption()) {
+        initEncryption();
+        buildContentInfo();
+    }
+
+    VirgilByteArray contentInfo;
+    if (embedContentInfo) {
+        contentInfo = getContentInfo();
+    }
+
+    // Prepared encryption is kept, so caller can retry with a bigger buffer.
+    if (outputSize < contentInfo.size() + encryptedPayloadSize(dataSize)) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Output buffer is too small.");
+    }
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    auto& symmetricCipher = getSymmetricCipher();
+    auto outputBegin = output;
+    auto outputEnd = output + outputSize;
+
+    output = std::copy(contentInfo.cbegin(), contentInfo.cend(), output);
+    output += symmetricCipher.update(data, dataSize, output, outputEnd - output);
+    output += symmetricCipher.finish(output, outputEnd - output);
+
+    return output - outputBegin;
+}
+
+size_t VirgilCipher::decryptInto(
+        const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize,
         const VirgilByteArray& recipientId, const VirgilByteArray& privateKey,
         const VirgilByteArray& privateKeyPassword) {
 
     initDecryptionWithKey(recipientId, privateKey, privateKeyPassword);
 
-    return decrypt(encryptedData);
+    return decrypt(encryptedData, encryptedDataSize, output, outputSize);
 }
 
-VirgilByteArray VirgilCipher::decryptWithPassword(const VirgilByteArray& encryptedData, const VirgilByteArray& pwd) {
+size_t VirgilCipher::decryptInto(
+        const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize,
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
+
+    initDecryptionWithKey(recipientId, privateKey);
+
+    return decrypt(encryptedData, encryptedDataSize, output, outputSize);
+}
+
+size_t VirgilCipher::decryptInto(
+        const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize,
+        const VirgilByteArray& pwd) {
 
     initDecryptionWithPassword(pwd);
 
-    return decrypt(encryptedData);
+    return decrypt(encryptedData, encryptedDataSize, output, outputSize);
 }
 
 
-VirgilByteArray VirgilCipher::decrypt(const VirgilByteArray& encryptedData) {
+size_t VirgilCipher::decrypt(
+        const unsigned char* encryptedData, size_t encryptedDataSize, unsigned char* output, size_t outputSize) {
 
     auto disposer = ScopeGuard([this]() {
         clear();
     });
 
-    auto payload = filterAndSetupContentInfo(encryptedData, true);
+    const size_t contentInfoSize = setupContentInfo(encryptedData, encryptedDataSize);
 
-    size_t payloadSize = payload.size();
+    const auto payload = encryptedData + contentInfoSize;
+    const size_t payloadSize = encryptedDataSize - contentInfoSize;
 
-    auto decryptedData = getSymmetricCipher().update(payload);
-    auto decryptedDataEnd = getSymmetricCipher().finish();
+    auto& symmetricCipher = getSymmetricCipher();
+    auto outputBegin = output;
+    auto outputEnd = output + outputSize;
 
-    VirgilByteArrayUtils::append(decryptedData, decryptedDataEnd);
+    output += symmetricCipher.update(payload, payloadSize, output, outputEnd - output);
+    output += symmetricCipher.finish(output, outputEnd - output);
 
-    return decryptedData;
+    return output - outputBegin;
+}
+
+size_t VirgilCipher::encryptedPayloadSize(size_t dataSize) {
+    const auto& symmetricCipher = getSymmetricCipher();
+    if (symmetricCipher.isSupportPadding()) {
+        return (dataSize / symmetricCipher.blockSize() + 1) * symmetricCipher.blockSize();
+    }
+    return dataSize + symmetricCipher.authTagLength();
 }
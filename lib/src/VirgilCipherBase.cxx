@@ -45,7 +45,10 @@
 #include <virgil/crypto/foundation/VirgilPBE.h>
 
 #include "utils.h"
+#include "ScopeGuard.h"
 #include "VirgilContentInfoFilter.h"
+#include "VirgilKeyHandleImpl.h"
+#include "VirgilSecureByteArray.h"
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
@@ -53,15 +56,30 @@ using virgil::crypto::VirgilCipherBase;
 using virgil::crypto::VirgilCustomParams;
 using virgil::crypto::VirgilCryptoError;
 using virgil::crypto::VirgilContentInfo;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
+using virgil::crypto::VirgilRecipientSet;
 using virgil::crypto::make_error;
 
 using virgil::crypto::foundation::VirgilRandom;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
 using virgil::crypto::foundation::VirgilPBE;
+using virgil::crypto::foundation::internal::VirgilSecureByteArray;
+using virgil::crypto::foundation::internal::VirgilSecureBytesCopy;
 
 using virgil::crypto::internal::VirgilContentInfoFilter;
 
+/**
+ * @name Configuration constants.
+ */
+///@{
+static constexpr VirgilSymmetricCipher::Padding
+        kSymmetricCipher_Padding = VirgilSymmetricCipher::Padding::PKCS7;
+static constexpr VirgilSymmetricCipher::Algorithm
+        kSymmetricCipher_Algorithm = VirgilSymmetricCipher::Algorithm::AES_256_GCM;
+///@}
+
 namespace virgil { namespace crypto {
 
 /**
@@ -72,32 +90,29 @@ public:
     Impl() noexcept :
             random(VirgilByteArrayUtils::stringToBytes(std::string("virgil::VirgilCipherBase"))),
             symmetricCipher(), symmetricCipherKey(), contentInfo(), contentInfoFilter(),
-            recipientId(), privateKey(), pwd(), isInited(false) {}
+            keyRecipientHandles(), recipientEncryptionThreads(1),
+            contentEncryptionAlgorithm(kSymmetricCipher_Algorithm),
+            recipientId(), privateKey(), privateKeyHandle(), pwd(),
+            isInited(false) {}
 
 public:
     VirgilRandom random;
     VirgilSymmetricCipher symmetricCipher;
-    VirgilByteArray symmetricCipherKey;
+    VirgilSecureByteArray symmetricCipherKey;
     VirgilContentInfo contentInfo;
     VirgilContentInfoFilter contentInfoFilter;
+    std::map<VirgilByteArray, VirgilPublicKeyHandle> keyRecipientHandles; ///< recipient id -> parsed public key
+    size_t recipientEncryptionThreads;
+    VirgilSymmetricCipher::Algorithm contentEncryptionAlgorithm;
     VirgilByteArray recipientId;
-    VirgilByteArray privateKey;
-    VirgilByteArray pwd;
+    VirgilSecureByteArray privateKey;
+    std::unique_ptr<VirgilPrivateKeyHandle> privateKeyHandle;
+    VirgilSecureByteArray pwd;
     bool isInited;
 };
 
 }}
 
-/**
- * @name Configuration constants.
- */
-///@{
-static constexpr VirgilSymmetricCipher::Padding
-        kSymmetricCipher_Padding = VirgilSymmetricCipher::Padding::PKCS7;
-static constexpr VirgilSymmetricCipher::Algorithm
-        kSymmetricCipher_Algorithm = VirgilSymmetricCipher::Algorithm::AES_256_GCM;
-///@}
-
 VirgilCipherBase::VirgilCipherBase() : impl_(std::make_unique<Impl>()) {}
 
 VirgilCipherBase::VirgilCipherBase(VirgilCipherBase&& rhs) noexcept = default;
@@ -108,11 +123,31 @@ VirgilCipherBase::~VirgilCipherBase() noexcept = default;
 
 void VirgilCipherBase::addKeyRecipient(const VirgilByteArray& recipientId, const VirgilByteArray& publicKey) {
     VirgilAsymmetricCipher::checkPublicKey(publicKey);
+    discardPreparedEncryption();
     impl_->contentInfo.addKeyRecipient(recipientId, publicKey);
 }
 
+void VirgilCipherBase::addKeyRecipient(const VirgilByteArray& recipientId, const VirgilPublicKeyHandle& publicKey) {
+    discardPreparedEncryption();
+    impl_->contentInfo.addKeyRecipient(recipientId, publicKey.impl_->publicKey);
+    impl_->keyRecipientHandles.emplace(recipientId, publicKey);
+}
+
+void VirgilCipherBase::addKeyRecipients(const VirgilRecipientSet& recipients) {
+    for (const auto& keyRecipient : recipients.keyRecipients_) {
+        if (keyRecipientExists(keyRecipient.first)) {
+            throw make_error(VirgilCryptoError::InvalidArgument);
+        }
+    }
+    for (const auto& keyRecipient : recipients.keyRecipients_) {
+        addKeyRecipient(keyRecipient.first, keyRecipient.second);
+    }
+}
+
 void VirgilCipherBase::removeKeyRecipient(const VirgilByteArray& recipientId) {
+    discardPreparedEncryption();
     impl_->contentInfo.removeKeyRecipient(recipientId);
+    impl_->keyRecipientHandles.erase(recipientId);
 }
 
 bool VirgilCipherBase::keyRecipientExists(const VirgilByteArray& recipientId) const {
@@ -120,10 +155,12 @@ bool VirgilCipherBase::keyRecipientExists(const VirgilByteArray& recipientId) co
 }
 
 void VirgilCipherBase::addPasswordRecipient(const VirgilByteArray& pwd) {
+    discardPreparedEncryption();
     impl_->contentInfo.addPasswordRecipient(pwd);
 }
 
 void VirgilCipherBase::removePasswordRecipient(const VirgilByteArray& pwd) {
+    discardPreparedEncryption();
     return impl_->contentInfo.removePasswordRecipient(pwd);
 }
 
@@ -132,7 +169,37 @@ bool VirgilCipherBase::passwordRecipientExists(const VirgilByteArray& password)
 }
 
 void VirgilCipherBase::removeAllRecipients() {
+    discardPreparedEncryption();
     impl_->contentInfo.removeAllRecipients();
+    impl_->keyRecipientHandles.clear();
+}
+
+void VirgilCipherBase::setRecipientEncryptionThreads(size_t threadsNum) {
+    if (threadsNum == 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Number of threads must be greater than zero.");
+    }
+    impl_->recipientEncryptionThreads = threadsNum;
+}
+
+size_t VirgilCipherBase::getRecipientEncryptionThreads() const {
+    return impl_->recipientEncryptionThreads;
+}
+
+void VirgilCipherBase::setContentEncryptionAlgorithm(VirgilSymmetricCipher::Algorithm algorithm) {
+    switch (algorithm) {
+        case VirgilSymmetricCipher::Algorithm::AES_128_GCM:
+        case VirgilSymmetricCipher::Algorithm::AES_256_GCM:
+            discardPreparedEncryption();
+            impl_->contentEncryptionAlgorithm = algorithm;
+            break;
+        default:
+            throw make_error(VirgilCryptoError::InvalidArgument,
+                    "Content encryption algorithm must be authenticated (AEAD): " + std::to_string(algorithm));
+    }
+}
+
+VirgilSymmetricCipher::Algorithm VirgilCipherBase::getContentEncryptionAlgorithm() const {
+    return impl_->contentEncryptionAlgorithm;
 }
 
 VirgilByteArray VirgilCipherBase::getContentInfo() const {
@@ -166,17 +233,41 @@ VirgilByteArray VirgilCipherBase::computeShared(
     return VirgilAsymmetricCipher::computeShared(publicContext, privateContext);
 }
 
+VirgilByteArray VirgilCipherBase::computeShared(
+        const VirgilPublicKeyHandle& publicKey, const VirgilPrivateKeyHandle& privateKey) {
+
+    std::lock_guard<std::mutex> publicKeyLock(publicKey.impl_->mutex);
+    std::lock_guard<std::mutex> privateKeyLock(privateKey.impl_->mutex);
+    return VirgilAsymmetricCipher::computeShared(publicKey.impl_->cipher, privateKey.impl_->cipher);
+}
 
-VirgilByteArray VirgilCipherBase::filterAndSetupContentInfo(const VirgilByteArray& encryptedData, bool isLastChunk) {
 
-    size_t encryptedDataSize = encryptedData.size();
+VirgilByteArray VirgilCipherBase::filterAndSetupContentInfo(const VirgilByteArray& encryptedData, bool isLastChunk) {
 
     if (impl_->contentInfoFilter.isDone()) {
         return encryptedData;
     }
 
+    VirgilByteArray payload;
+    const size_t payloadOffset =
+            filterAndSetupContentInfo(encryptedData.data(), encryptedData.size(), isLastChunk, payload);
+    payload.insert(payload.end(), encryptedData.cbegin() + payloadOffset, encryptedData.cend());
+    return payload;
+}
+
+size_t VirgilCipherBase::filterAndSetupContentInfo(
+        const unsigned char* encryptedData, size_t encryptedDataSize, bool isLastChunk,
+        VirgilByteArray& heldData) {
+
+    heldData.clear();
+
+    if (impl_->contentInfoFilter.isDone()) {
+        return 0;
+    }
+
+    size_t payloadOffset = encryptedDataSize;
     if (impl_->contentInfoFilter.isWaitingData()) {
-        impl_->contentInfoFilter.filterData(encryptedData);
+        payloadOffset = impl_->contentInfoFilter.filterData(encryptedData, encryptedDataSize);
     }
 
     if (isLastChunk) {
@@ -186,13 +277,15 @@ VirgilByteArray VirgilCipherBase::filterAndSetupContentInfo(const VirgilByteArra
     if (impl_->contentInfoFilter.isContentInfoAbsent()) {
         impl_->contentInfoFilter.finish();
         accomplishInitDecryption();
-        return impl_->contentInfoFilter.popEncryptedData();
+        heldData = impl_->contentInfoFilter.popEncryptedData();
+        return payloadOffset;
 
     } else if (impl_->contentInfoFilter.isContentInfoFound()) {
         setContentInfo(impl_->contentInfoFilter.popContentInfo());
         impl_->contentInfoFilter.finish();
         accomplishInitDecryption();
-        return impl_->contentInfoFilter.popEncryptedData();
+        heldData = impl_->contentInfoFilter.popEncryptedData();
+        return payloadOffset;
 
     } else if (impl_->contentInfoFilter.isContentInfoBroken()) {
         throw make_error(VirgilCryptoError::InvalidArgument,
@@ -203,16 +296,40 @@ VirgilByteArray VirgilCipherBase::filterAndSetupContentInfo(const VirgilByteArra
     }
 
     //  Still waiting for data to be filtered.
-    return VirgilByteArray();
+    return encryptedDataSize;
 }
 
+size_t VirgilCipherBase::setupContentInfo(const unsigned char* encryptedData, size_t encryptedDataSize) {
+    constexpr size_t kContentInfoPreambleSize = 16;
+
+    size_t contentInfoSize = 0;
+    if (encryptedDataSize >= kContentInfoPreambleSize) {
+        contentInfoSize = VirgilContentInfo::defineSize(
+                VirgilByteArray(encryptedData, encryptedData + kContentInfoPreambleSize));
+    }
+
+    if (contentInfoSize > encryptedDataSize) {
+        throw make_error(VirgilCryptoError::InvalidArgument,
+            "Content Info extracted from the encrypted data is broken.");
+    }
+
+    if (contentInfoSize > 0) {
+        setContentInfo(VirgilByteArray(encryptedData, encryptedData + contentInfoSize));
+    }
+
+    accomplishInitDecryption();
+
+    return contentInfoSize;
+}
 
 void VirgilCipherBase::initEncryption() {
 
-    impl_->symmetricCipher = VirgilSymmetricCipher(kSymmetricCipher_Algorithm);
-    impl_->symmetricCipherKey = impl_->random.randomize(impl_->symmetricCipher.keyLength());
+    impl_->symmetricCipher = VirgilSymmetricCipher(impl_->contentEncryptionAlgorithm);
+    auto symmetricCipherKey = impl_->random.randomize(impl_->symmetricCipher.keyLength());
+    impl_->symmetricCipherKey.assign(symmetricCipherKey.cbegin(), symmetricCipherKey.cend());
     auto symmetricCipherIV = impl_->random.randomize(impl_->symmetricCipher.ivSize());
-    impl_->symmetricCipher.setEncryptionKey(impl_->symmetricCipherKey);
+    impl_->symmetricCipher.setEncryptionKey(symmetricCipherKey);
+    VirgilByteArrayUtils::zeroize(symmetricCipherKey);
     impl_->symmetricCipher.setIV(symmetricCipherIV);
 
     if (impl_->symmetricCipher.isSupportPadding()) {
@@ -226,6 +343,9 @@ void VirgilCipherBase::initEncryption() {
 
 void VirgilCipherBase::accomplishInitDecryption() {
     VirgilByteArray contentEncryptionKey;
+    auto contentEncryptionKeyDisposer = ScopeGuard([&contentEncryptionKey]() {
+        VirgilByteArrayUtils::zeroize(contentEncryptionKey);
+    });
 
     if (!impl_->contentInfo.isReadyForDecryption()) {
         throw make_error(VirgilCryptoError::InvalidState,
@@ -239,7 +359,8 @@ void VirgilCipherBase::accomplishInitDecryption() {
                 [&, this](
                         const VirgilByteArray& keyEncryptionAlgorithm,
                         const VirgilByteArray& encryptedKey) -> VirgilByteArray {
-                    return doDecryptWithPassword(encryptedKey, keyEncryptionAlgorithm, impl_->pwd);
+                    const VirgilSecureBytesCopy pwd(impl_->pwd);
+                    return doDecryptWithPassword(encryptedKey, keyEncryptionAlgorithm, pwd.get());
                 }
         );
 
@@ -252,7 +373,14 @@ void VirgilCipherBase::accomplishInitDecryption() {
         contentEncryptionKey = impl_->contentInfo.decryptKeyRecipient(
                 impl_->recipientId,
                 [&, this](const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey) -> VirgilByteArray {
-                    return doDecryptWithKey(algorithm, encryptedKey, impl_->privateKey, impl_->pwd);
+                    if (impl_->privateKeyHandle) {
+                        auto& privateKeyHandle = *impl_->privateKeyHandle->impl_;
+                        std::lock_guard<std::mutex> lock(privateKeyHandle.mutex);
+                        return privateKeyHandle.cipher.decrypt(encryptedKey);
+                    }
+                    const VirgilSecureBytesCopy privateKey(impl_->privateKey);
+                    const VirgilSecureBytesCopy pwd(impl_->pwd);
+                    return doDecryptWithKey(algorithm, encryptedKey, privateKey.get(), pwd.get());
                 }
         );
 
@@ -264,6 +392,7 @@ void VirgilCipherBase::accomplishInitDecryption() {
     impl_->symmetricCipher = VirgilSymmetricCipher();
     impl_->symmetricCipher.fromAsn1(impl_->contentInfo.getContentEncryptionAlgorithm());
     impl_->symmetricCipher.setDecryptionKey(contentEncryptionKey);
+    impl_->symmetricCipherKey.assign(contentEncryptionKey.cbegin(), contentEncryptionKey.cend());
 
     if (impl_->symmetricCipher.isSupportPadding()) {
         impl_->symmetricCipher.setPadding(kSymmetricCipher_Padding);
@@ -278,7 +407,7 @@ void VirgilCipherBase::initDecryptionWithPassword(const VirgilByteArray& pwd) {
         throw make_error(VirgilCryptoError::InvalidArgument, "Can not decrypt with empty 'pwd'");
     }
 
-    impl_->pwd = pwd;
+    impl_->pwd.assign(pwd.cbegin(), pwd.cend());
     impl_->isInited = true;
 }
 
@@ -296,22 +425,47 @@ void VirgilCipherBase::initDecryptionWithKey(
     }
 
     impl_->recipientId = recipientId;
-    impl_->privateKey = privateKey;
-    impl_->pwd = privateKeyPassword;
+    impl_->privateKey.assign(privateKey.cbegin(), privateKey.cend());
+    impl_->privateKeyHandle.reset();
+    impl_->pwd.assign(privateKeyPassword.cbegin(), privateKeyPassword.cend());
+    impl_->isInited = true;
+}
+
+
+void VirgilCipherBase::initDecryptionWithKey(
+        const VirgilByteArray& recipientId, const VirgilPrivateKeyHandle& privateKey) {
+
+    if (recipientId.empty()) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not decrypt with empty 'recipientId'");
+    }
+
+    impl_->recipientId = recipientId;
+    impl_->privateKeyHandle = std::make_unique<VirgilPrivateKeyHandle>(privateKey);
     impl_->isInited = true;
 }
 
 
 void VirgilCipherBase::buildContentInfo() {
-    const auto& symmetricCipherKey = impl_->symmetricCipherKey;
+    const VirgilSecureBytesCopy symmetricCipherKeyCopy(impl_->symmetricCipherKey);
+    const auto& symmetricCipherKey = symmetricCipherKeyCopy.get();
+    const auto& keyRecipientHandles = impl_->keyRecipientHandles;
     auto& random = impl_->random;
 
     impl_->contentInfo.encryptKeyRecipients(
-            [&symmetricCipherKey](const VirgilByteArray& publicKey) -> VirgilContentInfo::EncryptionResult {
+            [&symmetricCipherKey, &keyRecipientHandles](
+                    const VirgilByteArray& recipientId,
+                    const VirgilByteArray& publicKey) -> VirgilContentInfo::EncryptionResult {
+                auto keyRecipientHandle = keyRecipientHandles.find(recipientId);
+                if (keyRecipientHandle != keyRecipientHandles.end()) {
+                    auto& publicKeyHandle = *keyRecipientHandle->second.impl_;
+                    std::lock_guard<std::mutex> lock(publicKeyHandle.mutex);
+                    return { publicKeyHandle.cipher.toAsn1(), publicKeyHandle.cipher.encrypt(symmetricCipherKey) };
+                }
                 VirgilAsymmetricCipher asymmetricCipher;
                 asymmetricCipher.setPublicKey(publicKey);
                 return { asymmetricCipher.toAsn1(), asymmetricCipher.encrypt(symmetricCipherKey) };
-            }
+            },
+            impl_->recipientEncryptionThreads
     );
 
     impl_->contentInfo.encryptPasswordRecipients(
@@ -332,11 +486,12 @@ void VirgilCipherBase::clear() {
     impl_->isInited = false;
     impl_->symmetricCipher.clear();
     impl_->recipientId.clear();
+    impl_->privateKeyHandle.reset();
     impl_->contentInfoFilter.reset();
 
-    VirgilByteArrayUtils::zeroize(impl_->symmetricCipherKey);
-    VirgilByteArrayUtils::zeroize(impl_->privateKey);
-    VirgilByteArrayUtils::zeroize(impl_->pwd);
+    bytes_zeroize(impl_->symmetricCipherKey);
+    bytes_zeroize(impl_->privateKey);
+    bytes_zeroize(impl_->pwd);
 
     impl_->symmetricCipherKey.clear();
     impl_->privateKey.clear();
@@ -354,6 +509,13 @@ bool VirgilCipherBase::isReadyForEncryption() const {
 }
 
 
+void VirgilCipherBase::discardPreparedEncryption() {
+    if (isReadyForEncryption()) {
+        clear();
+    }
+}
+
+
 bool VirgilCipherBase::isReadyForDecryption() const {
     return impl_->symmetricCipher.isInited() && impl_->symmetricCipher.isDecryptionMode();
 }
@@ -363,6 +525,28 @@ VirgilSymmetricCipher& VirgilCipherBase::getSymmetricCipher() {
     return impl_->symmetricCipher;
 }
 
+VirgilSymmetricCipher VirgilCipherBase::cloneSymmetricCipher() const {
+    if (!impl_->symmetricCipher.isInited() || impl_->symmetricCipherKey.empty()) {
+        throw make_error(VirgilCryptoError::InvalidState, "Symmetric cipher is not initialized.");
+    }
+
+    VirgilSymmetricCipher symmetricCipher;
+    symmetricCipher.fromAsn1(impl_->symmetricCipher.toAsn1());
+
+    const VirgilSecureBytesCopy symmetricCipherKey(impl_->symmetricCipherKey);
+    if (impl_->symmetricCipher.isEncryptionMode()) {
+        symmetricCipher.setEncryptionKey(symmetricCipherKey.get());
+    } else {
+        symmetricCipher.setDecryptionKey(symmetricCipherKey.get());
+    }
+
+    if (symmetricCipher.isSupportPadding()) {
+        symmetricCipher.setPadding(kSymmetricCipher_Padding);
+    }
+
+    return symmetricCipher;
+}
+
 
 VirgilByteArray VirgilCipherBase::doDecryptWithKey(
         const VirgilByteArray& algorithm, const VirgilByteArray& encryptedKey,
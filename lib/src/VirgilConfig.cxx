@@ -36,6 +36,9 @@
 
 #include "VirgilConfig.h"
 
+#include <mbedtls/aesni.h>
+#include <mbedtls/padlock.h>
+
 using virgil::crypto::VirgilConfig;
 
 bool VirgilConfig::hasFeatureStreamImpl() {
@@ -49,3 +52,17 @@ bool VirgilConfig::hasFeaturePythiaImpl() {
 bool VirgilConfig::hasFeaturePythiaMultiThread() {
     return VIRGIL_CRYPTO_FEATURE_PYTHIA_MT;
 }
+
+std::string VirgilConfig::activeCipherBackend() {
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+    if (mbedtls_aesni_has_support(MBEDTLS_AESNI_AES)) {
+        return mbedtls_aesni_has_support(MBEDTLS_AESNI_CLMUL) ? "aesni-clmul" : "aesni";
+    }
+#endif
+#if defined(MBEDTLS_PADLOCK_C) && defined(MBEDTLS_HAVE_X86)
+    if (mbedtls_padlock_has_support(MBEDTLS_PADLOCK_ACE)) {
+        return "padlock";
+    }
+#endif
+    return "portable";
+}
@@ -44,9 +44,12 @@
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
 #include "utils.h"
+#include "VirgilParallel.h"
+#include "VirgilEncodedKeyRecipients.h"
 
 #include <algorithm>
 #include <set>
+#include <vector>
 
 
 using virgil::crypto::VirgilContentInfo;
@@ -64,6 +67,8 @@ using virgil::crypto::foundation::cms::VirgilCMSPasswordRecipient;
 using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
 using virgil::crypto::foundation::asn1::VirgilAsn1Writer;
 
+using virgil::crypto::internal::VirgilEncodedKeyRecipients;
+
 
 namespace virgil { namespace crypto {
 
@@ -74,6 +79,7 @@ class VirgilContentInfo::Impl {
 public:
     VirgilCMSContentInfo cmsContentInfo;
     VirgilCMSEnvelopedData cmsEnvelopedData;
+    VirgilEncodedKeyRecipients encodedKeyRecipients; ///< read key recipients, that are decoded on demand
     std::map<VirgilByteArray, VirgilByteArray> keyRecipients; ///< recipient id -> public key
     std::set<VirgilByteArray> passwordRecipients; ///< passwords
 };
@@ -107,6 +113,9 @@ bool VirgilContentInfo::hasKeyRecipient(const VirgilByteArray& recipientId) cons
         return true;
     }
     // 2. Search within CMS representation
+    if (!impl_->encodedKeyRecipients.isEmpty()) {
+        return impl_->encodedKeyRecipients.contains(recipientId);
+    }
     return std::find_if(
             impl_->cmsEnvelopedData.keyTransRecipients.cbegin(),
             impl_->cmsEnvelopedData.keyTransRecipients.cend(),
@@ -120,6 +129,7 @@ void VirgilContentInfo::removeKeyRecipient(const VirgilByteArray& recipientId) {
     // Remove from the RAW representation
     impl_->keyRecipients.erase(recipientId);
     // Remove from the CMS representation
+    impl_->encodedKeyRecipients.decodeAll(impl_->cmsEnvelopedData.keyTransRecipients);
     auto found = std::find_if(
             // Use non const iterators, it's cause an error for vector::erase() in gcc 4.8.5
             impl_->cmsEnvelopedData.keyTransRecipients.begin(),
@@ -138,6 +148,7 @@ void VirgilContentInfo::removeKeyRecipients() {
     impl_->keyRecipients.clear();
     // Remove from the CMS representation
     impl_->cmsEnvelopedData.keyTransRecipients.clear();
+    impl_->encodedKeyRecipients.clear();
 }
 
 void VirgilContentInfo::addPasswordRecipient(const VirgilByteArray& pwd) {
@@ -185,6 +196,13 @@ VirgilByteArray VirgilContentInfo::decryptKeyRecipient(const VirgilByteArray& re
     if (!decrypt) {
         throw make_error(VirgilCryptoError::InvalidArgument);
     }
+    if (!impl_->encodedKeyRecipients.isEmpty()) {
+        VirgilCMSKeyTransRecipient keyRecipient;
+        if (impl_->encodedKeyRecipients.find(recipientId, keyRecipient)) {
+            return decrypt(keyRecipient.keyEncryptionAlgorithm, keyRecipient.encryptedKey);
+        }
+        return VirgilByteArray();
+    }
     for (const auto& keyRecipient: impl_->cmsEnvelopedData.keyTransRecipients) {
         if (keyRecipient.recipientIdentifier == recipientId) {
             return decrypt(keyRecipient.keyEncryptionAlgorithm, keyRecipient.encryptedKey);
@@ -208,30 +226,40 @@ VirgilByteArray VirgilContentInfo::decryptPasswordRecipient(
     return VirgilByteArray();
 }
 
-void VirgilContentInfo::encryptKeyRecipients(std::function<EncryptionResult(const VirgilByteArray&)> encrypt) {
+void VirgilContentInfo::encryptKeyRecipients(
+        std::function<EncryptionResult(const VirgilByteArray&, const VirgilByteArray&)> encrypt, size_t threadsNum) {
     if (!encrypt) {
         throw make_error(VirgilCryptoError::InvalidArgument);
     }
-    for (const auto& keyRecipient : impl_->keyRecipients) {
-        const auto& recipientId = keyRecipient.first;
-        const auto& publicKey = keyRecipient.second;
+    std::vector<decltype(impl_->keyRecipients)::const_iterator> keyRecipients;
+    keyRecipients.reserve(impl_->keyRecipients.size());
+    for (auto keyRecipient = impl_->keyRecipients.cbegin(); keyRecipient != impl_->keyRecipients.cend(); ++keyRecipient) {
+        keyRecipients.push_back(keyRecipient);
+    }
 
-        auto encryptionResult = encrypt(publicKey);
+    std::vector<EncryptionResult> encryptionResults(keyRecipients.size());
+    internal::parallel_for(keyRecipients.size(), threadsNum, [&](size_t index) {
+        encryptionResults[index] = encrypt(keyRecipients[index]->first, keyRecipients[index]->second);
+    });
 
+    // Recipients are kept, so content key is encrypted for all of them on every call.
+    impl_->cmsEnvelopedData.keyTransRecipients.clear();
+    impl_->encodedKeyRecipients.clear();
+    for (size_t index = 0; index < keyRecipients.size(); ++index) {
         VirgilCMSKeyTransRecipient recipient;
-        recipient.recipientIdentifier = recipientId;
-        recipient.keyEncryptionAlgorithm = encryptionResult.encryptionAlgorithm;
-        recipient.encryptedKey = encryptionResult.encryptedContent;
+        recipient.recipientIdentifier = keyRecipients[index]->first;
+        recipient.keyEncryptionAlgorithm = std::move(encryptionResults[index].encryptionAlgorithm);
+        recipient.encryptedKey = std::move(encryptionResults[index].encryptedContent);
 
-        impl_->cmsEnvelopedData.keyTransRecipients.push_back(recipient);
+        impl_->cmsEnvelopedData.keyTransRecipients.push_back(std::move(recipient));
     }
-    impl_->keyRecipients.clear();
 }
 
 void VirgilContentInfo::encryptPasswordRecipients(std::function<EncryptionResult(const VirgilByteArray&)> encrypt) {
     if (!encrypt) {
         throw make_error(VirgilCryptoError::InvalidArgument);
     }
+    std::vector<VirgilCMSPasswordRecipient> passwordRecipients;
     for (const auto& password : impl_->passwordRecipients) {
         auto encryptionResult = encrypt(password);
 
@@ -239,9 +267,9 @@ void VirgilContentInfo::encryptPasswordRecipients(std::function<EncryptionResult
         recipient.keyEncryptionAlgorithm = encryptionResult.encryptionAlgorithm;
         recipient.encryptedKey = encryptionResult.encryptedContent;
 
-        impl_->cmsEnvelopedData.passwordRecipients.push_back(recipient);
+        passwordRecipients.push_back(recipient);
     }
-    impl_->passwordRecipients.clear();
+    impl_->cmsEnvelopedData.passwordRecipients.swap(passwordRecipients);
 }
 
 void VirgilContentInfo::setContentEncryptionAlgorithm(const VirgilByteArray& contentEncryptionAlgorithm) {
@@ -257,6 +285,7 @@ size_t VirgilContentInfo::defineSize(const VirgilByteArray& contentInfoData) {
 }
 
 size_t VirgilContentInfo::asn1Write(VirgilAsn1Writer& asn1Writer, size_t childWrittenBytes) const {
+    impl_->encodedKeyRecipients.decodeAll(impl_->cmsEnvelopedData.keyTransRecipients);
     impl_->cmsContentInfo.cmsContent.contentType = VirgilCMSContent::Type::EnvelopedData;
     impl_->cmsContentInfo.cmsContent.content = impl_->cmsEnvelopedData.toAsn1();
     return impl_->cmsContentInfo.asn1Write(asn1Writer, childWrittenBytes);
@@ -265,7 +294,9 @@ size_t VirgilContentInfo::asn1Write(VirgilAsn1Writer& asn1Writer, size_t childWr
 void VirgilContentInfo::asn1Read(VirgilAsn1Reader& asn1Reader) {
     impl_->cmsContentInfo.asn1Read(asn1Reader);
     if (impl_->cmsContentInfo.cmsContent.contentType == foundation::cms::VirgilCMSContent::Type::EnvelopedData) {
-        impl_->cmsEnvelopedData.fromAsn1(impl_->cmsContentInfo.cmsContent.content);
+        impl_->cmsEnvelopedData.keyTransRecipients.clear();
+        impl_->encodedKeyRecipients.read(
+                std::move(impl_->cmsContentInfo.cmsContent.content), impl_->cmsEnvelopedData);
     } else {
         throw make_error(VirgilCryptoError::InvalidFormat);
     }
@@ -276,6 +307,7 @@ bool VirgilContentInfo::isReadyForEncryption() {
 }
 
 bool VirgilContentInfo::isReadyForDecryption() {
-    return !impl_->cmsEnvelopedData.keyTransRecipients.empty() || !impl_->cmsEnvelopedData.passwordRecipients.empty();
+    return !impl_->cmsEnvelopedData.keyTransRecipients.empty() || !impl_->encodedKeyRecipients.isEmpty() ||
+            !impl_->cmsEnvelopedData.passwordRecipients.empty();
 }
 
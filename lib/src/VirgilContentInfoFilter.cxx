@@ -36,6 +36,7 @@
 
 #include "VirgilContentInfoFilter.h"
 
+#include <algorithm>
 
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilCryptoError.h>
@@ -89,6 +90,7 @@ void VirgilContentInfoFilter::reset() {
     impl_->state = State::WaitingPreamble;
     impl_->contentInfoData.clear();
     impl_->encryptedData.clear();
+    impl_->expectedContentInfoSize = 0;
 }
 
 void VirgilContentInfoFilter::finish() {
@@ -125,46 +127,52 @@ void VirgilContentInfoFilter::tellLastChunk() {
 }
 
 void VirgilContentInfoFilter::filterData(const VirgilByteArray& encryptedData) {
+    const size_t offset = filterData(encryptedData.data(), encryptedData.size());
+    impl_->encryptedData.insert(impl_->encryptedData.end(), encryptedData.cbegin() + offset, encryptedData.cend());
+}
+
+size_t VirgilContentInfoFilter::filterData(const unsigned char* encryptedData, size_t encryptedDataSize) {
     if (!isWaitingData()) {
         throw make_error(VirgilCryptoError::InvalidState, "VirgilContentInfoFilter::filterData()");
     }
 
-    // Append new data.
-    VirgilByteArrayUtils::append(impl_->contentInfoData, encryptedData);
+    auto& contentInfoData = impl_->contentInfoData;
 
-    // Check preamble size.
-    if (impl_->contentInfoData.size() < kContentInfoPreambleSize) {
-        return;
-    }
-
-    // Define content info first time.
+    // Define content info size from the preamble first time.
     if (impl_->expectedContentInfoSize == 0) {
-        impl_->expectedContentInfoSize = VirgilContentInfo::defineSize(impl_->contentInfoData);
+        if (contentInfoData.size() + encryptedDataSize < kContentInfoPreambleSize) {
+            contentInfoData.insert(contentInfoData.end(), encryptedData, encryptedData + encryptedDataSize);
+            return encryptedDataSize;
+        }
+
+        VirgilByteArray preamble(contentInfoData);
+        preamble.insert(preamble.end(), encryptedData, encryptedData + kContentInfoPreambleSize - preamble.size());
+        impl_->expectedContentInfoSize = VirgilContentInfo::defineSize(preamble);
+
+        // If content info size still zero, then it is not a content info.
+        if (impl_->expectedContentInfoSize == 0) {
+            impl_->encryptedData.swap(contentInfoData);
+            impl_->state = State::NotFound;
+            return 0;
+        }
     }
 
-    // If content info size still zero, then it is not a content info.
-    if (impl_->expectedContentInfoSize == 0) {
-        impl_->encryptedData.swap(impl_->contentInfoData);
-        impl_->state = State::NotFound;
-        return;
-    }
+    // Take only content info bytes, the rest of data is left in place.
+    const size_t contentInfoPartSize = impl_->expectedContentInfoSize > contentInfoData.size() ?
+            std::min(impl_->expectedContentInfoSize - contentInfoData.size(), encryptedDataSize) : 0;
+    contentInfoData.insert(contentInfoData.end(), encryptedData, encryptedData + contentInfoPartSize);
 
     // Check if content info fully extracted.
-    if (impl_->contentInfoData.size() >= impl_->expectedContentInfoSize) {
-        size_t contentInfoDataSize = impl_->contentInfoData.size();
-        size_t encryptedDataSize = impl_->encryptedData.size();
-
+    if (contentInfoData.size() >= impl_->expectedContentInfoSize) {
         impl_->encryptedData.insert(impl_->encryptedData.end(),
-                impl_->contentInfoData.begin() + impl_->expectedContentInfoSize, impl_->contentInfoData.end());
-        impl_->contentInfoData.resize(impl_->expectedContentInfoSize);
+                contentInfoData.begin() + impl_->expectedContentInfoSize, contentInfoData.end());
+        contentInfoData.resize(impl_->expectedContentInfoSize);
         impl_->state = State::Found;
-
-        encryptedDataSize = impl_->encryptedData.size();
-        contentInfoDataSize = impl_->contentInfoData.size();
-        return;
+    } else {
+        impl_->state = State::WaitingBody;
     }
 
-    impl_->state = State::WaitingBody;
+    return contentInfoPartSize;
 }
 
 bool VirgilContentInfoFilter::isWaitingData() const {
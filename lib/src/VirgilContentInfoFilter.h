@@ -108,6 +108,19 @@ public:
      */
     void filterData(const VirgilByteArray& encryptedData);
 
+    /**
+     * Filter given encrypted data to define Content Info without copying data that follows it.
+     *
+     * Content Info size is defined from the preamble, and then only Content Info bytes are taken from the data.
+     * Data that was taken from the previous invocations, but is not a Content Info, can be extracted
+     * with @link popEncryptedData() @endlink and it precedes the data located at the returned offset.
+     *
+     * @param encryptedData - data to be filtered.
+     * @param encryptedDataSize - size of the data to be filtered.
+     * @return Offset of the first byte within given data that was not taken by the filter.
+     */
+    size_t filterData(const unsigned char* encryptedData, size_t encryptedDataSize);
+
     /**
      * Return true if filter needs more data for analyzing.
      */
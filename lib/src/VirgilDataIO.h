@@ -0,0 +1,70 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_DATA_IO_H
+#define VIRGIL_CRYPTO_DATA_IO_H
+
+#include <cstddef>
+
+#include <virgil/crypto/VirgilDataSource.h>
+#include <virgil/crypto/VirgilDataSink.h>
+#include <virgil/crypto/VirgilDataReader.h>
+#include <virgil/crypto/VirgilDataWriter.h>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Size of the buffer that is used to process data with VirgilDataReader and VirgilDataWriter.
+ */
+constexpr size_t kDataBufferSize = 64 * 1024;
+
+/**
+ * @brief Return source as a reader if it supports reading to the caller buffer, otherwise - nullptr.
+ */
+inline VirgilDataReader* as_data_reader(VirgilDataSource& source) {
+    return dynamic_cast<VirgilDataReader*>(&source);
+}
+
+/**
+ * @brief Return sink as a writer if it supports writing from the caller buffer, otherwise - nullptr.
+ */
+inline VirgilDataWriter* as_data_writer(VirgilDataSink& sink) {
+    return dynamic_cast<VirgilDataWriter*>(&sink);
+}
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_DATA_IO_H */
@@ -0,0 +1,65 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilDataReaderSource.h>
+
+#include <algorithm>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataReader;
+using virgil::crypto::VirgilDataReaderSource;
+
+static const size_t kChunkSizeMin = 1;
+
+constexpr size_t VirgilDataReaderSource::kChunkSizeDefault;
+
+VirgilDataReaderSource::VirgilDataReaderSource(VirgilDataReader& reader, size_t chunkSize)
+        : reader_(reader), chunkSize_(std::max(chunkSize, kChunkSizeMin)) {
+}
+
+bool VirgilDataReaderSource::hasData() {
+    return reader_.hasData();
+}
+
+VirgilByteArray VirgilDataReaderSource::read() {
+    VirgilByteArray result(chunkSize_);
+    result.resize(reader_.readInto(result.data(), result.size()));
+    return result;
+}
+
+size_t VirgilDataReaderSource::readInto(unsigned char* buffer, size_t bufferSize) {
+    return reader_.readInto(buffer, bufferSize);
+}
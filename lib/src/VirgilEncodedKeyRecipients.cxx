@@ -0,0 +1,217 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilEncodedKeyRecipients.h"
+
+#include <cstdint>
+
+#include <mbedtls/asn1.h>
+
+#include <virgil/crypto/foundation/VirgilSystemCryptoError.h>
+#include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::internal::VirgilEncodedKeyRecipients;
+using virgil::crypto::foundation::cms::VirgilCMSEnvelopedData;
+using virgil::crypto::foundation::cms::VirgilCMSKeyTransRecipient;
+using virgil::crypto::foundation::cms::VirgilCMSPasswordRecipient;
+using virgil::crypto::foundation::asn1::VirgilAsn1Reader;
+using virgil::crypto::foundation::system_crypto_handler;
+
+/**
+ * @name ASN.1 Constants for CMS
+ */
+///@{
+static const unsigned char kCMS_OriginatorInfoTag = 0;
+static const unsigned char kCMS_KeyAgreeRecipientTag = 1;
+static const unsigned char kCMS_KEKRecipientTag = 2;
+static const unsigned char kCMS_PasswordRecipientTag = 3;
+static const unsigned char kCMS_OtherRecipientTag = 4;
+static const unsigned char kCMS_SubjectKeyTag = 0;
+///@}
+
+static constexpr int context_tag(unsigned char tag) {
+    return MBEDTLS_ASN1_CONTEXT_SPECIFIC | MBEDTLS_ASN1_CONSTRUCTED | tag;
+}
+
+static size_t read_tag(unsigned char** p, const unsigned char* end, int tag) {
+    size_t len = 0;
+    system_crypto_handler(
+            mbedtls_asn1_get_tag(p, end, &len, tag),
+            [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidFormat)); }
+    );
+    return len;
+}
+
+/**
+ * @brief Skip ASN.1 element of any type.
+ * @return Pointer to the element start.
+ */
+static unsigned char* skip_element(unsigned char** p, const unsigned char* end) {
+    unsigned char* start = *p;
+    if (*p >= end) {
+        throw make_error(VirgilCryptoError::InvalidFormat);
+    }
+    size_t len = 0;
+    *p += 1; // Ignore tag value
+    system_crypto_handler(
+            mbedtls_asn1_get_len(p, end, &len),
+            [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidFormat)); }
+    );
+    *p += len;
+    return start;
+}
+
+void VirgilEncodedKeyRecipients::read(VirgilByteArray envelopedDataAsn1, VirgilCMSEnvelopedData& envelopedData) {
+    clear();
+    envelopedData.passwordRecipients.clear();
+    envelopedDataAsn1_ = std::move(envelopedDataAsn1);
+
+    unsigned char* const begin = envelopedDataAsn1_.data();
+    unsigned char* p = begin;
+    const unsigned char* end = begin + envelopedDataAsn1_.size();
+
+    const size_t envelopedDataLen = read_tag(&p, end, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
+    end = p + envelopedDataLen;
+    int version = 0;
+    system_crypto_handler(
+            mbedtls_asn1_get_int(&p, end, &version),
+            [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidFormat)); }
+    ); // Ignore version
+    if (p < end && *p == context_tag(kCMS_OriginatorInfoTag)) {
+        (void) skip_element(&p, end); // Ignore originatorInfo
+    }
+
+    const size_t recipientInfosLen = read_tag(&p, end, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SET);
+    const unsigned char* setEnd = p + recipientInfosLen;
+    while (p < setEnd) {
+        unsigned char* recipientStart = skip_element(&p, setEnd);
+        const unsigned char recipientTag = *recipientStart;
+        if (recipientTag == context_tag(kCMS_PasswordRecipientTag)) {
+            VirgilAsn1Reader recipientAsn1Reader(VirgilByteArray(recipientStart, p));
+            (void) recipientAsn1Reader.readContextTag(kCMS_PasswordRecipientTag);
+            VirgilCMSPasswordRecipient recipient;
+            recipient.fromAsn1(recipientAsn1Reader.readData());
+            envelopedData.passwordRecipients.push_back(recipient);
+        } else if (recipientTag == context_tag(kCMS_KeyAgreeRecipientTag) ||
+                recipientTag == context_tag(kCMS_KEKRecipientTag) ||
+                recipientTag == context_tag(kCMS_OtherRecipientTag)) {
+            throw make_error(VirgilCryptoError::UnsupportedAlgorithm, "Unsupported CMS RecipientInfo.");
+        } else {
+            recipients_.emplace_back(recipientStart - begin, p - recipientStart);
+        }
+    }
+
+    unsigned char* encryptedContentStart = skip_element(&p, end);
+    envelopedData.encryptedContent.fromAsn1(VirgilByteArray(encryptedContentStart, p));
+}
+
+bool VirgilEncodedKeyRecipients::isEmpty() const {
+    return recipients_.empty();
+}
+
+bool VirgilEncodedKeyRecipients::contains(const VirgilByteArray& recipientId) {
+    buildIndex();
+    return index_.find(recipientId) != index_.end();
+}
+
+bool VirgilEncodedKeyRecipients::find(const VirgilByteArray& recipientId, VirgilCMSKeyTransRecipient& recipient) {
+    buildIndex();
+    const auto found = index_.find(recipientId);
+    if (found == index_.end()) {
+        return false;
+    }
+    recipient = decode(found->second);
+    return true;
+}
+
+void VirgilEncodedKeyRecipients::decodeAll(std::vector<VirgilCMSKeyTransRecipient>& recipients) {
+    recipients.reserve(recipients.size() + recipients_.size());
+    for (size_t recipientIndex = 0; recipientIndex < recipients_.size(); ++recipientIndex) {
+        recipients.push_back(decode(recipientIndex));
+    }
+    clear();
+}
+
+void VirgilEncodedKeyRecipients::clear() {
+    envelopedDataAsn1_.clear();
+    recipients_.clear();
+    index_.clear();
+    isIndexed_ = false;
+}
+
+void VirgilEncodedKeyRecipients::buildIndex() {
+    if (isIndexed_) {
+        return;
+    }
+    index_.reserve(recipients_.size());
+    for (size_t recipientIndex = 0; recipientIndex < recipients_.size(); ++recipientIndex) {
+        unsigned char* p = envelopedDataAsn1_.data() + recipients_[recipientIndex].first;
+        const unsigned char* end = p + recipients_[recipientIndex].second;
+
+        const size_t recipientLen = read_tag(&p, end, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
+        end = p + recipientLen;
+        (void) skip_element(&p, end); // Skip version, it is checked when recipient is decoded
+        if (p >= end || *p != context_tag(kCMS_SubjectKeyTag)) {
+            throw make_error(VirgilCryptoError::InvalidFormat,
+                    "KeyTransRecipientInfo structure is malformed. Parameter 'rid' is not defined.");
+        }
+        (void) read_tag(&p, end, context_tag(kCMS_SubjectKeyTag));
+        const size_t recipientIdLen = read_tag(&p, end, MBEDTLS_ASN1_OCTET_STRING);
+        // The first recipient wins, as with sequential search.
+        index_.emplace(VirgilByteArray(p, p + recipientIdLen), recipientIndex);
+    }
+    isIndexed_ = true;
+}
+
+VirgilCMSKeyTransRecipient VirgilEncodedKeyRecipients::decode(size_t recipientIndex) const {
+    const auto recipientStart = envelopedDataAsn1_.cbegin() + recipients_[recipientIndex].first;
+    VirgilCMSKeyTransRecipient recipient;
+    recipient.fromAsn1(VirgilByteArray(recipientStart, recipientStart + recipients_[recipientIndex].second));
+    return recipient;
+}
+
+size_t VirgilEncodedKeyRecipients::ByteArrayHash::operator()(const VirgilByteArray& bytes) const noexcept {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (const auto byte : bytes) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+}
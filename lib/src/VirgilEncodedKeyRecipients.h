@@ -0,0 +1,116 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_ENCODED_KEY_RECIPIENTS_H
+#define VIRGIL_CRYPTO_ENCODED_KEY_RECIPIENTS_H
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/foundation/cms/VirgilCMSEnvelopedData.h>
+#include <virgil/crypto/foundation/cms/VirgilCMSKeyTransRecipient.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * Holds KeyTransRecipientInfo structures of the read CMS EnvelopedData in the encoded form.
+ *
+ * Recipient is decoded only when it is requested by its identifier.
+ *     On the first request identifiers of all recipients are indexed,
+ *     so lookup cost does not depend on the number of recipients afterwards.
+ */
+class VirgilEncodedKeyRecipients {
+public:
+    /**
+     * Read CMS EnvelopedData structure.
+     *
+     * Password recipients and encrypted content are decoded into the given structure,
+     *     key recipients are kept encoded.
+     *
+     * @param envelopedDataAsn1 - encoded CMS EnvelopedData structure.
+     * @param envelopedData - structure to be filled, key recipients are left untouched.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidFormat, if structure is malformed.
+     * @throw VirgilCryptoException with VirgilCryptoError::UnsupportedAlgorithm, if unsupported recipient is found.
+     */
+    void read(VirgilByteArray envelopedDataAsn1, foundation::cms::VirgilCMSEnvelopedData& envelopedData);
+
+    /**
+     * Return true if there are no encoded recipients.
+     */
+    bool isEmpty() const;
+
+    /**
+     * Return true if recipient with given identifier exists.
+     */
+    bool contains(const VirgilByteArray& recipientId);
+
+    /**
+     * Decode recipient with given identifier.
+     * @return true if recipient was found and decoded.
+     */
+    bool find(const VirgilByteArray& recipientId, foundation::cms::VirgilCMSKeyTransRecipient& recipient);
+
+    /**
+     * Decode all recipients in the original order, append them to the given container and clear.
+     */
+    void decodeAll(std::vector<foundation::cms::VirgilCMSKeyTransRecipient>& recipients);
+
+    /**
+     * Drop all recipients.
+     */
+    void clear();
+
+private:
+    struct ByteArrayHash {
+        size_t operator()(const VirgilByteArray& bytes) const noexcept;
+    };
+
+    void buildIndex();
+
+    foundation::cms::VirgilCMSKeyTransRecipient decode(size_t recipientIndex) const;
+
+private:
+    VirgilByteArray envelopedDataAsn1_;
+    std::vector<std::pair<size_t, size_t>> recipients_; ///< (offset, length) within envelopedDataAsn1_
+    std::unordered_map<VirgilByteArray, size_t, ByteArrayHash> index_; ///< recipient id -> index in recipients_
+    bool isIndexed_ = false;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_ENCODED_KEY_RECIPIENTS_H */
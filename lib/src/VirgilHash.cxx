@@ -45,6 +45,7 @@
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
 #include "utils.h"
+#include "VirgilParallel.h"
 #include "mbedtls_context.h"
 #include "mbedtls_type_utils.h"
 
@@ -159,9 +160,13 @@ void VirgilHash::start() {
 }
 
 void VirgilHash::update(const VirgilByteArray& data) {
+    update(data.data(), data.size());
+}
+
+void VirgilHash::update(const unsigned char* data, size_t dataSize) {
     checkState();
     system_crypto_handler(
-            mbedtls_md_update(impl_->md_ctx.get(), data.data(), data.size()),
+            mbedtls_md_update(impl_->md_ctx.get(), data, dataSize),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
     );
 }
@@ -177,15 +182,41 @@ VirgilByteArray VirgilHash::finish() {
 }
 
 VirgilByteArray VirgilHash::hash(const VirgilByteArray& data) const {
+    return hash(data.data(), data.size());
+}
+
+VirgilByteArray VirgilHash::hash(const unsigned char* data, size_t dataSize) const {
     checkState();
     VirgilByteArray digest(impl_->info.size());
     system_crypto_handler(
-            mbedtls_md(impl_->md_ctx.get()->md_info, data.data(), data.size(), digest.data()),
+            mbedtls_md(impl_->md_ctx.get()->md_info, data, dataSize, digest.data()),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
     );
     return digest;
 }
 
+VirgilByteArray VirgilHash::hashBatch(const std::vector<InputSegment>& messages, size_t threadsNum) const {
+    checkState();
+    if (threadsNum == 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Number of threads can not be zero.");
+    }
+    for (const auto& message : messages) {
+        if (message.data == nullptr && message.size > 0) {
+            throw make_error(VirgilCryptoError::InvalidArgument, "Message data is not defined.");
+        }
+    }
+    const auto mdInfo = impl_->md_ctx.get()->md_info;
+    const auto digestSize = impl_->info.size();
+    VirgilByteArray digests(messages.size() * digestSize);
+    virgil::crypto::internal::parallel_for(messages.size(), threadsNum, [&](size_t index) {
+        system_crypto_handler(
+                mbedtls_md(mdInfo, messages[index].data, messages[index].size, digests.data() + index * digestSize),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
+        );
+    });
+    return digests;
+}
+
 void VirgilHash::hmacStart(const VirgilByteArray& key) {
     checkState();
     system_crypto_handler(
@@ -203,9 +234,13 @@ void VirgilHash::hmacReset() {
 }
 
 void VirgilHash::hmacUpdate(const VirgilByteArray& data) {
+    hmacUpdate(data.data(), data.size());
+}
+
+void VirgilHash::hmacUpdate(const unsigned char* data, size_t dataSize) {
     checkState();
     system_crypto_handler(
-            mbedtls_md_hmac_update(impl_->hmac_ctx.get(), data.data(), data.size()),
+            mbedtls_md_hmac_update(impl_->hmac_ctx.get(), data, dataSize),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
     );
 }
@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_KEY_HANDLE_IMPL_H
+#define VIRGIL_CRYPTO_KEY_HANDLE_IMPL_H
+
+#include <mutex>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilPrivateKeyHandle.h>
+#include <virgil/crypto/VirgilPublicKeyHandle.h>
+#include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+
+namespace virgil { namespace crypto {
+
+/**
+ * @brief Handle class fields.
+ * @note Parsed key context is mutated by some operations (i.e. RSA blinding, EC precomputations),
+ *       so every access to the cipher MUST be guarded with mutex.
+ */
+class VirgilPrivateKeyHandle::Impl {
+public:
+    Impl(const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword) : mutex(), cipher() {
+        cipher.setPrivateKey(privateKey, privateKeyPassword);
+    }
+
+public:
+    std::mutex mutex;
+    foundation::VirgilAsymmetricCipher cipher;
+};
+
+/**
+ * @brief Handle class fields.
+ * @note Every access to the cipher MUST be guarded with mutex.
+ */
+class VirgilPublicKeyHandle::Impl {
+public:
+    explicit Impl(const VirgilByteArray& publicKey) : mutex(), cipher(), publicKey(publicKey) {
+        cipher.setPublicKey(publicKey);
+    }
+
+public:
+    std::mutex mutex;
+    foundation::VirgilAsymmetricCipher cipher;
+    const VirgilByteArray publicKey; ///< original key, it is used as recipient's public key in the content info
+};
+
+}}
+
+#endif /* VIRGIL_CRYPTO_KEY_HANDLE_IMPL_H */
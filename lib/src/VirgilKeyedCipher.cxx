@@ -0,0 +1,94 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/foundation/VirgilKeyedCipher.h>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+#include "utils.h"
+#include "VirgilSymmetricCrypt.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::make_error;
+using virgil::crypto::foundation::VirgilKeyedCipher;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
+using virgil::crypto::foundation::internal::symmetric_crypt;
+
+class VirgilKeyedCipher::Impl {
+public:
+    Impl(VirgilSymmetricCipher::Algorithm algorithm, const VirgilByteArray& key)
+            : encryptor(algorithm), decryptor(algorithm) {
+        if (!encryptor.isAuthMode()) {
+            throw make_error(VirgilCryptoError::InvalidArgument, "Keyed cipher requires authenticated algorithm.");
+        }
+        encryptor.setEncryptionKey(key);
+        decryptor.setDecryptionKey(key);
+    }
+
+    VirgilSymmetricCipher encryptor;
+    VirgilSymmetricCipher decryptor;
+};
+
+VirgilKeyedCipher::VirgilKeyedCipher(VirgilSymmetricCipher::Algorithm algorithm, const VirgilByteArray& key)
+        : impl_(std::make_unique<Impl>(algorithm, key)) {}
+
+VirgilKeyedCipher::VirgilKeyedCipher(VirgilKeyedCipher&&) noexcept = default;
+
+VirgilKeyedCipher& VirgilKeyedCipher::operator=(VirgilKeyedCipher&&) noexcept = default;
+
+VirgilKeyedCipher::~VirgilKeyedCipher() noexcept = default;
+
+size_t VirgilKeyedCipher::keyLength() const {
+    return impl_->encryptor.keyLength();
+}
+
+size_t VirgilKeyedCipher::nonceSize() const {
+    return impl_->encryptor.ivSize();
+}
+
+size_t VirgilKeyedCipher::authTagLength() const {
+    return impl_->encryptor.authTagLength();
+}
+
+VirgilByteArray VirgilKeyedCipher::encrypt(
+        const VirgilByteArray& plainText, const VirgilByteArray& nonce, const VirgilByteArray& authData) {
+    return symmetric_crypt(impl_->encryptor, plainText, nonce, authData);
+}
+
+VirgilByteArray VirgilKeyedCipher::decrypt(
+        const VirgilByteArray& cipherText, const VirgilByteArray& nonce, const VirgilByteArray& authData) {
+    return symmetric_crypt(impl_->decryptor, cipherText, nonce, authData);
+}
@@ -0,0 +1,333 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilMappedFile.h"
+
+#include <algorithm>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+#if defined(_WIN32)
+#   include <windows.h>
+#   define VIRGIL_MAPPED_FILE_WIN32 1
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#   include <cerrno>
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   define VIRGIL_MAPPED_FILE_POSIX 1
+#   if defined(__linux__) || defined(__FreeBSD__)
+#       define VIRGIL_MAPPED_FILE_FALLOCATE 1
+#   endif
+#endif
+
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::internal::VirgilMappedFile;
+
+constexpr size_t VirgilMappedFile::kWindowSize;
+
+#if VIRGIL_MAPPED_FILE_WIN32
+
+VirgilMappedFile::VirgilMappedFile(const std::string& path, bool writable)
+        : writable_(writable), size_(0), window_(nullptr), windowOffset_(0), windowSize_(0),
+          file_(INVALID_HANDLE_VALUE), mapping_(nullptr) {
+
+    file_ = CreateFileA(
+            path.c_str(), GENERIC_READ | (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ, nullptr,
+            writable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not open file: " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file_, &fileSize)) {
+        CloseHandle(file_);
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not define size of the file: " + path);
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+}
+
+VirgilMappedFile::~VirgilMappedFile() noexcept {
+    unmap();
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_);
+    }
+}
+
+bool VirgilMappedFile::isOpened() const noexcept {
+    return file_ != INVALID_HANDLE_VALUE;
+}
+
+unsigned char* VirgilMappedFile::map(size_t position, size_t& available) {
+    available = 0;
+    if (!isOpened() || (!writable_ && position >= size_)) {
+        return nullptr;
+    }
+
+    const size_t offset = position / kWindowSize * kWindowSize;
+    if (window_ == nullptr || offset != windowOffset_) {
+        unmap();
+        const size_t length = writable_ ? kWindowSize : std::min(kWindowSize, size_ - offset);
+        const unsigned long long mappingSize = static_cast<unsigned long long>(offset) + length;
+        mapping_ = CreateFileMappingA(
+                file_, nullptr, writable_ ? PAGE_READWRITE : PAGE_READONLY,
+                static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize & 0xFFFFFFFF), nullptr);
+        if (mapping_ == nullptr) {
+            throw make_error(VirgilCryptoError::InvalidState, "Can not map file.");
+        }
+        const unsigned long long viewOffset = offset;
+        void* view = MapViewOfFile(
+                mapping_, writable_ ? FILE_MAP_WRITE : FILE_MAP_READ,
+                static_cast<DWORD>(viewOffset >> 32), static_cast<DWORD>(viewOffset & 0xFFFFFFFF), length);
+        if (view == nullptr) {
+            unmap();
+            throw make_error(VirgilCryptoError::InvalidState, "Can not map file.");
+        }
+        window_ = static_cast<unsigned char*>(view);
+        windowOffset_ = offset;
+        windowSize_ = length;
+        size_ = std::max(size_, offset + length);
+    }
+
+    available = windowOffset_ + windowSize_ - position;
+    return window_ + (position - windowOffset_);
+}
+
+void VirgilMappedFile::unmap() noexcept {
+    if (window_ != nullptr) {
+        UnmapViewOfFile(window_);
+        window_ = nullptr;
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+}
+
+void VirgilMappedFile::resize(size_t size) {
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file_, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file_)) {
+        throw make_error(VirgilCryptoError::InvalidState, "Can not change file size.");
+    }
+    size_ = size;
+}
+
+void VirgilMappedFile::close(size_t size) {
+    if (!isOpened()) {
+        return;
+    }
+    unmap();
+    HANDLE file = file_;
+    file_ = INVALID_HANDLE_VALUE;
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    const bool isResized = !writable_ ||
+            (SetFilePointerEx(file, fileSize, nullptr, FILE_BEGIN) && SetEndOfFile(file));
+    CloseHandle(file);
+    if (!isResized) {
+        throw make_error(VirgilCryptoError::InvalidState, "Can not change file size.");
+    }
+    size_ = size;
+}
+
+#elif VIRGIL_MAPPED_FILE_POSIX
+
+VirgilMappedFile::VirgilMappedFile(const std::string& path, bool writable)
+        : writable_(writable), size_(0), window_(nullptr), windowOffset_(0), windowSize_(0), file_(-1) {
+
+    file_ = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+    if (file_ < 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not open file: " + path);
+    }
+
+    struct stat fileStat;
+    if (::fstat(file_, &fileStat) != 0) {
+        ::close(file_);
+        throw make_error(VirgilCryptoError::InvalidArgument, "Can not define size of the file: " + path);
+    }
+    size_ = static_cast<size_t>(fileStat.st_size);
+}
+
+VirgilMappedFile::~VirgilMappedFile() noexcept {
+    unmap();
+    if (file_ >= 0) {
+        ::close(file_);
+    }
+}
+
+bool VirgilMappedFile::isOpened() const noexcept {
+    return file_ >= 0;
+}
+
+unsigned char* VirgilMappedFile::map(size_t position, size_t& available) {
+    available = 0;
+    if (!isOpened() || (!writable_ && position >= size_)) {
+        return nullptr;
+    }
+
+    const size_t offset = position / kWindowSize * kWindowSize;
+    if (window_ == nullptr || offset != windowOffset_) {
+        unmap();
+        const size_t length = writable_ ? kWindowSize : std::min(kWindowSize, size_ - offset);
+        if (writable_ && size_ < offset + length) {
+            resize(offset + length);
+        }
+        void* view = ::mmap(
+                nullptr, length, writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED,
+                file_, static_cast<off_t>(offset));
+        if (view == MAP_FAILED) {
+            throw make_error(VirgilCryptoError::InvalidState, "Can not map file.");
+        }
+        (void)::posix_madvise(view, length, POSIX_MADV_SEQUENTIAL);
+        window_ = static_cast<unsigned char*>(view);
+        windowOffset_ = offset;
+        windowSize_ = length;
+    }
+
+    available = windowOffset_ + windowSize_ - position;
+    return window_ + (position - windowOffset_);
+}
+
+void VirgilMappedFile::unmap() noexcept {
+    if (window_ != nullptr) {
+        ::munmap(window_, windowSize_);
+        window_ = nullptr;
+    }
+}
+
+namespace {
+
+/**
+ * @brief Extend file by writing zeros, so all blocks in [from, to) are allocated.
+ * @return false, if file can not be extended, errno is set in this case.
+ */
+bool extend_with_zeros(int file, size_t from, size_t to) noexcept {
+    static const unsigned char zeros[4096] = { 0 };
+    while (from < to) {
+        const size_t chunkSize = std::min(sizeof(zeros), to - from);
+        const ssize_t written = ::pwrite(file, zeros, chunkSize, static_cast<off_t>(from));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        from += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+}
+
+void VirgilMappedFile::resize(size_t size) {
+    if (size <= size_) {
+        if (::ftruncate(file_, static_cast<off_t>(size)) != 0) {
+            throw make_error(VirgilCryptoError::InvalidState, "Can not change file size.");
+        }
+        size_ = size;
+        return;
+    }
+
+    // Blocks are reserved up front: writing to the sparse part of the mapped file
+    // raises SIGBUS when there is no space left, instead of returning an error.
+    bool isReserved = false;
+#if VIRGIL_MAPPED_FILE_FALLOCATE
+    const int result = ::posix_fallocate(file_, static_cast<off_t>(size_), static_cast<off_t>(size - size_));
+    if (result == 0) {
+        isReserved = true;
+    } else if (result != EINVAL && result != EOPNOTSUPP) {
+        throw make_error(VirgilCryptoError::InvalidState, "Can not reserve space for the file.");
+    }
+#endif
+    if (!isReserved && !extend_with_zeros(file_, size_, size)) {
+        // Return file to the previous size, so partially written zeros are not left.
+        (void)::ftruncate(file_, static_cast<off_t>(size_));
+        throw make_error(VirgilCryptoError::InvalidState, "Can not reserve space for the file.");
+    }
+    size_ = size;
+}
+
+void VirgilMappedFile::close(size_t size) {
+    if (!isOpened()) {
+        return;
+    }
+    unmap();
+    const int file = file_;
+    file_ = -1;
+    const bool isResized = !writable_ || ::ftruncate(file, static_cast<off_t>(size)) == 0;
+    ::close(file);
+    if (!isResized) {
+        throw make_error(VirgilCryptoError::InvalidState, "Can not change file size.");
+    }
+    size_ = size;
+}
+
+#else
+
+VirgilMappedFile::VirgilMappedFile(const std::string&, bool writable)
+        : writable_(writable), size_(0), window_(nullptr), windowOffset_(0), windowSize_(0), file_(-1) {
+    throw make_error(VirgilCryptoError::InvalidState, "Memory mapped files are not supported on this platform.");
+}
+
+VirgilMappedFile::~VirgilMappedFile() noexcept {
+}
+
+bool VirgilMappedFile::isOpened() const noexcept {
+    return false;
+}
+
+unsigned char* VirgilMappedFile::map(size_t, size_t& available) {
+    available = 0;
+    return nullptr;
+}
+
+void VirgilMappedFile::unmap() noexcept {
+}
+
+void VirgilMappedFile::resize(size_t) {
+}
+
+void VirgilMappedFile::close(size_t) {
+}
+
+#endif
+
+size_t VirgilMappedFile::size() const noexcept {
+    return size_;
+}
@@ -0,0 +1,127 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_MAPPED_FILE_H
+#define VIRGIL_CRYPTO_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief File that is accessed through the memory mapped window of the fixed size.
+ *
+ * Only one window is mapped at a time, so files of any size can be processed
+ *     within limited address space. Window is advised for the sequential access.
+ *
+ * @note Memory mapping is supported on POSIX and Windows platforms only.
+ */
+class VirgilMappedFile {
+public:
+    /**
+     * @brief Size of the mapped window, it is multiple of the page size and allocation granularity.
+     */
+    static constexpr size_t kWindowSize = 8 * 1024 * 1024;
+
+    /**
+     * @brief Open file for reading, or create (truncate) it for writing.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if file can not be opened.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if memory mapping is not supported.
+     */
+    VirgilMappedFile(const std::string& path, bool writable);
+
+    /**
+     * @brief Unmap window and close file.
+     */
+    ~VirgilMappedFile() noexcept;
+
+    VirgilMappedFile(const VirgilMappedFile&) = delete;
+
+    VirgilMappedFile& operator=(const VirgilMappedFile&) = delete;
+
+    /**
+     * @brief Return file size.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Map window that contains given position.
+     *
+     * For writable file, it is extended to cover the whole window, and disk space for the window is reserved,
+     *     so writes through the returned pointer can not fail because of the lack of space.
+     *
+     * @param position - offset from the beginning of the file.
+     * @param available - number of bytes that are accessible from the returned pointer.
+     * @return Pointer to the byte at given position.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if mapping failed,
+     *     or disk space for the window can not be reserved.
+     */
+    unsigned char* map(size_t position, size_t& available);
+
+    /**
+     * @brief Unmap window, set file size, and close file.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidState, if file size can not be changed.
+     */
+    void close(size_t size);
+
+    /**
+     * @brief Return true if file is opened.
+     */
+    bool isOpened() const noexcept;
+
+private:
+    void unmap() noexcept;
+
+    void resize(size_t size);
+
+private:
+    const bool writable_;
+    size_t size_;
+    unsigned char* window_;
+    size_t windowOffset_;
+    size_t windowSize_;
+#if defined(_WIN32)
+    void* file_;
+    void* mapping_;
+#else
+    int file_;
+#endif
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_MAPPED_FILE_H */
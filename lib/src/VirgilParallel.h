@@ -0,0 +1,62 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_PARALLEL_H
+#define VIRGIL_CRYPTO_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Call given function for each index in range [0, count) using up to threadsNum threads.
+ *
+ * Calling thread takes part in processing, so at most (threadsNum - 1) threads are spawned.
+ *     Indices are handed out dynamically, so results should be stored by index to keep them ordered.
+ *     If thread can not be spawned, remaining work is done by already running threads.
+ *
+ * @param count - number of items to be processed.
+ * @param threadsNum - maximum number of threads, 0 and 1 means processing within calling thread.
+ * @param func - function to be called for each index.
+ * @throw First exception thrown by func, when all threads are stopped.
+ *     Items that were not started yet are not processed in this case.
+ */
+void parallel_for(size_t count, size_t threadsNum, const std::function<void(size_t index)>& func);
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_PARALLEL_H */
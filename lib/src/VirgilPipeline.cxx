@@ -0,0 +1,309 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilPipeline.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataSource;
+using virgil::crypto::VirgilDataSink;
+
+namespace {
+
+/**
+ * @brief Blocking FIFO queue with limited capacity.
+ */
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity), closed_(false) {}
+
+    /**
+     * @brief Wait for free space and put item to the queue.
+     * @return false if queue was closed, item is not taken in this case.
+     */
+    bool push(VirgilByteArray& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Put item to the queue if it has free space.
+     */
+    void tryPush(VirgilByteArray& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!closed_ && items_.size() < capacity_) {
+            items_.push_back(std::move(item));
+            notEmpty_.notify_one();
+        }
+    }
+
+    /**
+     * @brief Wait for item and take it from the queue.
+     * @return false if queue was closed and has no items.
+     */
+    bool pop(VirgilByteArray& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Take item from the queue if it is not empty.
+     */
+    bool tryPop(VirgilByteArray& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Wake up all waiters, and reject new items.
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+private:
+    const size_t capacity_;
+    bool closed_;
+    std::deque<VirgilByteArray> items_;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
+
+/**
+ * @brief Remember first error that was thrown within any pipeline stage.
+ */
+class ErrorHolder {
+public:
+    void capture() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+
+    void rethrow() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief Run reader, transformation and writer (if sink is given) stages.
+ */
+void run_pipeline(
+        VirgilDataSource& source, VirgilDataSink* sink, size_t depth,
+        const std::function<void(const VirgilByteArray& input, VirgilByteArray& output)>& transform) {
+
+    BoundedQueue inputQueue(depth);
+    BoundedQueue outputQueue(depth);
+    BoundedQueue freeQueue(depth);
+    std::atomic<bool> stopped(false);
+    ErrorHolder error;
+
+    auto stop = [&]() {
+        stopped = true;
+        inputQueue.close();
+        outputQueue.close();
+    };
+
+    auto reader = [&]() {
+        try {
+            while (!stopped && source.hasData()) {
+                VirgilByteArray input = source.read();
+                if (!inputQueue.push(input)) {
+                    break;
+                }
+            }
+        } catch (...) {
+            error.capture();
+            stop();
+        }
+        inputQueue.close();
+    };
+
+    auto writer = [&]() {
+        try {
+            VirgilByteArray output;
+            while (outputQueue.pop(output)) {
+                if (stopped || !sink->isGood()) {
+                    break;
+                }
+                VirgilDataSink::safeWrite(*sink, output);
+                output.clear();
+                freeQueue.tryPush(output);
+            }
+        } catch (...) {
+            error.capture();
+        }
+        stop();
+    };
+
+    // Spawn helper threads, if it is not possible calling thread does their work.
+    std::thread readerThread;
+    std::thread writerThread;
+    try {
+        readerThread = std::thread(reader);
+    } catch (const std::system_error&) {
+    }
+    if (sink != nullptr) {
+        try {
+            writerThread = std::thread(writer);
+        } catch (const std::system_error&) {
+        }
+    }
+
+    try {
+        VirgilByteArray input;
+        VirgilByteArray output;
+        while (!stopped) {
+            if (readerThread.joinable()) {
+                if (!inputQueue.pop(input)) {
+                    break;
+                }
+            } else if (source.hasData() && (sink == nullptr || writerThread.joinable() || sink->isGood())) {
+                input = source.read();
+            } else {
+                break;
+            }
+
+            freeQueue.tryPop(output);
+            transform(input, output);
+
+            if (sink == nullptr) {
+                output.clear();
+            } else if (writerThread.joinable()) {
+                if (!outputQueue.push(output)) {
+                    break;
+                }
+            } else {
+                if (!sink->isGood()) {
+                    break;
+                }
+                VirgilDataSink::safeWrite(*sink, output);
+                output.clear();
+            }
+        }
+    } catch (...) {
+        error.capture();
+        stop();
+    }
+
+    // Let writer drain queued data and then stop all stages.
+    outputQueue.close();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    stop();
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+
+    error.rethrow();
+}
+
+}
+
+namespace virgil { namespace crypto { namespace internal {
+
+void pipeline_read(
+        VirgilDataSource& source, size_t depth, const std::function<void(const VirgilByteArray& data)>& consume) {
+
+    if (depth == 0) {
+        while (source.hasData()) {
+            consume(source.read());
+        }
+        return;
+    }
+
+    run_pipeline(source, nullptr, depth, [&consume](const VirgilByteArray& input, VirgilByteArray&) {
+        consume(input);
+    });
+}
+
+void pipeline_transform(
+        VirgilDataSource& source, VirgilDataSink& sink, size_t depth,
+        const std::function<void(const VirgilByteArray& input, VirgilByteArray& output)>& transform) {
+
+    if (depth == 0) {
+        VirgilByteArray output;
+        while (source.hasData() && sink.isGood()) {
+            output.clear();
+            transform(source.read(), output);
+            VirgilDataSink::safeWrite(sink, output);
+        }
+        return;
+    }
+
+    run_pipeline(source, &sink, depth, transform);
+}
+
+}}}
@@ -0,0 +1,86 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_PIPELINE_H
+#define VIRGIL_CRYPTO_PIPELINE_H
+
+#include <cstddef>
+#include <functional>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilDataSource.h>
+#include <virgil/crypto/VirgilDataSink.h>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Read data from the source and pass it to the given function.
+ *
+ * If depth is not zero, data is read within separate thread, and up to depth portions are read ahead.
+ *     Function is always called within calling thread in the order of reading.
+ *
+ * @param source - source of the data.
+ * @param depth - maximum number of portions that are read ahead, 0 means processing within calling thread.
+ * @param consume - function that takes read data.
+ * @throw First exception thrown by the source or function, when all threads are stopped.
+ */
+void pipeline_read(
+        VirgilDataSource& source, size_t depth, const std::function<void(const VirgilByteArray& data)>& consume);
+
+/**
+ * @brief Read data from the source, transform it, and write result to the sink.
+ *
+ * If depth is not zero, reading and writing are done within separate threads,
+ *     that are connected with the transformation by bounded queues of up to depth portions.
+ *     Output buffers are returned back after writing, so they are reused by the next transformations.
+ *     Transformation is always done within calling thread, and data is written in the order of reading,
+ *     so result is identical to the sequential processing.
+ *
+ * Processing stops when source is exhausted or sink becomes bad.
+ *
+ * @param source - source of the data.
+ * @param sink - target sink for the transformed data.
+ * @param depth - maximum number of portions within every queue, 0 means processing within calling thread.
+ * @param transform - function that takes read data, and fills given (empty) output buffer.
+ * @throw First exception thrown by the source, sink or function, when all threads are stopped.
+ */
+void pipeline_transform(
+        VirgilDataSource& source, VirgilDataSink& sink, size_t depth,
+        const std::function<void(const VirgilByteArray& input, VirgilByteArray& output)>& transform);
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_PIPELINE_H */
@@ -0,0 +1,215 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/foundation/VirgilPrivateKeyCache.h>
+
+#include <list>
+#include <map>
+#include <mutex>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+#include <virgil/crypto/foundation/VirgilHash.h>
+
+#include "VirgilSecureByteArray.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::VirgilPrivateKeyCache;
+using virgil::crypto::foundation::internal::VirgilSecureByteArray;
+
+namespace {
+
+struct CacheEntry {
+    VirgilByteArray fingerprint;
+    VirgilSecureByteArray decryptedKey;
+};
+
+/**
+ * @brief Shared state of the cache.
+ * @note It is never destroyed, so keys can be safely parsed by static objects at exit.
+ */
+class PrivateKeyCacheState {
+public:
+    std::mutex mutex;
+    bool enabled = false;
+    size_t maxEntries = 0;
+    size_t maxMemory = 0;
+    size_t memoryUsage = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    //! Most recently used entry goes first.
+    std::list<CacheEntry> entries;
+    std::map<VirgilByteArray, std::list<CacheEntry>::iterator> index;
+
+    void evictLast() {
+        auto& entry = entries.back();
+        memoryUsage -= entry.decryptedKey.size();
+        bytes_zeroize(entry.decryptedKey);
+        index.erase(entry.fingerprint);
+        entries.pop_back();
+    }
+
+    void evictExceeding() {
+        while (!entries.empty() && (entries.size() > maxEntries || memoryUsage > maxMemory)) {
+            evictLast();
+        }
+    }
+
+    void evictAll() {
+        while (!entries.empty()) {
+            evictLast();
+        }
+    }
+};
+
+PrivateKeyCacheState& cache_state() {
+    static PrivateKeyCacheState* state = new PrivateKeyCacheState();
+    return *state;
+}
+
+VirgilByteArray fingerprint(const VirgilByteArray& key, const VirgilByteArray& pwd) {
+    return VirgilHash(VirgilHash::Algorithm::SHA256).hmac(pwd, key);
+}
+
+}
+
+void VirgilPrivateKeyCache::enable(size_t maxEntries, size_t maxMemory) {
+    if (maxEntries == 0 || maxMemory == 0) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Private key cache limits must be greater than zero.");
+    }
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.enabled = true;
+    state.maxEntries = maxEntries;
+    state.maxMemory = maxMemory;
+    state.evictExceeding();
+}
+
+void VirgilPrivateKeyCache::disable() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.enabled = false;
+    state.evictAll();
+}
+
+bool VirgilPrivateKeyCache::isEnabled() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.enabled;
+}
+
+void VirgilPrivateKeyCache::clear() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.evictAll();
+}
+
+void VirgilPrivateKeyCache::resetStats() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.hits = 0;
+    state.misses = 0;
+}
+
+size_t VirgilPrivateKeyCache::hits() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.hits;
+}
+
+size_t VirgilPrivateKeyCache::misses() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.misses;
+}
+
+size_t VirgilPrivateKeyCache::size() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.entries.size();
+}
+
+size_t VirgilPrivateKeyCache::memoryUsage() {
+    auto& state = cache_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.memoryUsage;
+}
+
+bool VirgilPrivateKeyCache::find(const VirgilByteArray& key, const VirgilByteArray& pwd, VirgilByteArray& decryptedKey) {
+    auto& state = cache_state();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.enabled) {
+            return false;
+        }
+    }
+    const auto keyFingerprint = fingerprint(key, pwd);
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    const auto found = state.index.find(keyFingerprint);
+    if (found == state.index.end()) {
+        ++state.misses;
+        return false;
+    }
+    ++state.hits;
+    state.entries.splice(state.entries.begin(), state.entries, found->second);
+    decryptedKey.assign(found->second->decryptedKey.cbegin(), found->second->decryptedKey.cend());
+    return true;
+}
+
+void VirgilPrivateKeyCache::store(const VirgilByteArray& key, const VirgilByteArray& pwd, VirgilByteArray decryptedKey) {
+    auto& state = cache_state();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.enabled || decryptedKey.size() > state.maxMemory) {
+            virgil::crypto::bytes_zeroize(decryptedKey);
+            return;
+        }
+    }
+    auto keyFingerprint = fingerprint(key, pwd);
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.enabled || state.index.count(keyFingerprint) > 0) {
+        virgil::crypto::bytes_zeroize(decryptedKey);
+        return;
+    }
+    state.memoryUsage += decryptedKey.size();
+    state.entries.push_front(
+            CacheEntry{ keyFingerprint, VirgilSecureByteArray(decryptedKey.cbegin(), decryptedKey.cend()) });
+    virgil::crypto::bytes_zeroize(decryptedKey);
+    state.index.emplace(std::move(keyFingerprint), state.entries.begin());
+    state.evictExceeding();
+}
@@ -36,7 +36,6 @@
 
 #include <virgil/crypto/foundation/VirgilRandom.h>
 
-#include <mbedtls/entropy.h>
 #include <mbedtls/ctr_drbg.h>
 
 #include <virgil/crypto/VirgilByteArrayUtils.h>
@@ -44,18 +43,19 @@
 
 #include "utils.h"
 #include "mbedtls_context.h"
+#include "VirgilRandomPool.h"
 
 
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilByteArrayUtils;
 
 using virgil::crypto::foundation::VirgilRandom;
+using virgil::crypto::foundation::internal::VirgilRandomPool;
 
 class VirgilRandom::Impl {
 public:
     VirgilByteArray personalInfo;
-    internal::mbedtls_context <mbedtls_ctr_drbg_context> ctr_drbg_ctx;
-    internal::mbedtls_context <mbedtls_entropy_context> entropy_ctx;
+    VirgilRandomPool::Lease ctr_drbg_ctx;
 };
 
 VirgilRandom::VirgilRandom(const VirgilByteArray& personalInfo) : impl_(std::make_unique<Impl>()) {
@@ -87,17 +87,17 @@ VirgilRandom& VirgilRandom::operator=(const VirgilRandom& rhs) {
 }
 
 VirgilByteArray VirgilRandom::randomize(size_t bytesNum) {
-    return internal::randomize(impl_->ctr_drbg_ctx, bytesNum);
+    return internal::randomize(impl_->ctr_drbg_ctx.get(), bytesNum);
 }
 
 size_t VirgilRandom::randomize() {
-    return internal::randomize(impl_->ctr_drbg_ctx);
+    return internal::randomize(impl_->ctr_drbg_ctx.get());
 }
 
 size_t VirgilRandom::randomize(size_t min, size_t max) {
-    return internal::randomize(impl_->ctr_drbg_ctx, min, max);
+    return internal::randomize(impl_->ctr_drbg_ctx.get(), min, max);
 }
 
 void VirgilRandom::init() {
-    impl_->ctr_drbg_ctx.setup(mbedtls_entropy_func, impl_->entropy_ctx.get(), impl_->personalInfo);
+    impl_->ctr_drbg_ctx = VirgilRandomPool::acquire(impl_->personalInfo);
 }
@@ -0,0 +1,223 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilRandomPool.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <mbedtls/entropy.h>
+
+#include <virgil/crypto/foundation/VirgilSystemCryptoError.h>
+
+#include "utils.h"
+#include "mbedtls_context.h"
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#   include <pthread.h>
+#   define VIRGIL_RANDOM_POOL_FORK_SAFE 1
+#else
+#   define VIRGIL_RANDOM_POOL_FORK_SAFE 0
+#endif
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::foundation::internal::VirgilRandomPool;
+using virgil::crypto::foundation::internal::mbedtls_context;
+
+constexpr int VirgilRandomPool::kReseedInterval;
+constexpr size_t VirgilRandomPool::kIdleContextsMax;
+
+struct VirgilRandomPool::Entry {
+    mbedtls_context<mbedtls_ctr_drbg_context> ctr_drbg_ctx;
+    unsigned long forkGeneration = 0;
+};
+
+namespace {
+
+/**
+ * @brief Shared state of the pool.
+ * @note It is never destroyed, so leases held by static objects can be safely released at exit.
+ */
+class RandomPoolState {
+public:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<VirgilRandomPool::Entry>> idle;
+
+    std::mutex entropyMutex;
+    mbedtls_context<mbedtls_entropy_context> entropy_ctx;
+
+    std::atomic<unsigned long> forkGeneration{0};
+};
+
+RandomPoolState& pool_state();
+
+#if VIRGIL_RANDOM_POOL_FORK_SAFE
+
+void fork_prepare() {
+    pool_state().mutex.lock();
+    pool_state().entropyMutex.lock();
+}
+
+void fork_parent() {
+    pool_state().entropyMutex.unlock();
+    pool_state().mutex.unlock();
+}
+
+void fork_child() {
+    ++pool_state().forkGeneration;
+    pool_state().entropyMutex.unlock();
+    pool_state().mutex.unlock();
+}
+
+#endif /* VIRGIL_RANDOM_POOL_FORK_SAFE */
+
+RandomPoolState* create_pool_state() {
+    auto state = new RandomPoolState();
+#if VIRGIL_RANDOM_POOL_FORK_SAFE
+    pthread_atfork(fork_prepare, fork_parent, fork_child);
+#endif /* VIRGIL_RANDOM_POOL_FORK_SAFE */
+    return state;
+}
+
+RandomPoolState& pool_state() {
+    static RandomPoolState* state = create_pool_state();
+    return *state;
+}
+
+/**
+ * @brief Entropy callback shared by all pooled contexts.
+ *
+ * Contexts reseed themselves from different threads, so access to the entropy context is serialized.
+ */
+int locked_entropy_func(void* data, unsigned char* output, size_t len) {
+    auto state = static_cast<RandomPoolState*>(data);
+    std::lock_guard<std::mutex> lock(state->entropyMutex);
+    return mbedtls_entropy_func(state->entropy_ctx.get(), output, len);
+}
+
+} // namespace
+
+
+VirgilRandomPool::Lease::Lease() noexcept : entry_() {}
+
+VirgilRandomPool::Lease::Lease(std::unique_ptr<Entry> entry) noexcept : entry_(std::move(entry)) {}
+
+VirgilRandomPool::Lease::Lease(Lease&& rhs) noexcept = default;
+
+VirgilRandomPool::Lease& VirgilRandomPool::Lease::operator=(Lease&& rhs) noexcept {
+    if (this != &rhs) {
+        release();
+        entry_ = std::move(rhs.entry_);
+    }
+    return *this;
+}
+
+VirgilRandomPool::Lease::~Lease() noexcept {
+    release();
+}
+
+VirgilRandomPool::Lease::operator bool() const noexcept {
+    return entry_ != nullptr;
+}
+
+mbedtls_ctr_drbg_context* VirgilRandomPool::Lease::get() {
+    if (!entry_) {
+        throw make_error(VirgilCryptoError::NotInitialized, "Random context is not leased.");
+    }
+
+    auto& state = pool_state();
+    const auto forkGeneration = state.forkGeneration.load();
+    if (entry_->forkGeneration != forkGeneration) {
+        // Child process must not produce the same random sequence as its parent.
+        system_crypto_handler(
+                mbedtls_ctr_drbg_reseed(entry_->ctr_drbg_ctx.get(), nullptr, 0),
+                [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
+        );
+        entry_->forkGeneration = forkGeneration;
+    }
+    return entry_->ctr_drbg_ctx.get();
+}
+
+void VirgilRandomPool::Lease::release() noexcept {
+    if (!entry_) {
+        return;
+    }
+
+    auto& state = pool_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (entry_->forkGeneration == state.forkGeneration.load() && state.idle.size() < kIdleContextsMax) {
+        try {
+            state.idle.push_back(std::move(entry_));
+        } catch (...) {
+            // Context is simply destroyed when it can not be returned.
+        }
+    }
+    entry_.reset();
+}
+
+VirgilRandomPool::Lease VirgilRandomPool::acquire() {
+    auto& state = pool_state();
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.idle.empty()) {
+            auto entry = std::move(state.idle.back());
+            state.idle.pop_back();
+            return Lease(std::move(entry));
+        }
+    }
+
+    constexpr const char pers[] = "VirgilRandomPool";
+    auto entry = std::make_unique<Entry>();
+    entry->ctr_drbg_ctx.setup(locked_entropy_func, &state, pers);
+    mbedtls_ctr_drbg_set_reseed_interval(entry->ctr_drbg_ctx.get(), kReseedInterval);
+    entry->forkGeneration = state.forkGeneration.load();
+    return Lease(std::move(entry));
+}
+
+VirgilRandomPool::Lease VirgilRandomPool::acquire(const VirgilByteArray& personalInfo) {
+    auto lease = acquire();
+    if (!personalInfo.empty()) {
+        mbedtls_ctr_drbg_update(lease.get(), personalInfo.data(), personalInfo.size());
+    }
+    return lease;
+}
+
+size_t VirgilRandomPool::idleCount() {
+    auto& state = pool_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.idle.size();
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_RANDOM_POOL_H
+#define VIRGIL_CRYPTO_RANDOM_POOL_H
+
+#include <memory>
+
+#include <mbedtls/ctr_drbg.h>
+
+#include <virgil/crypto/VirgilByteArray.h>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief Process-wide source of seeded CTR-DRBG contexts.
+ *
+ * Seeding CTR-DRBG requires entropy gathering, which is expensive when it is done
+ * for every short-living object. This pool seeds each context once and then hands it out
+ * exclusively to one owner at a time, so in a steady state the number of contexts
+ * is about the number of threads that use them simultaneously.
+ *
+ * Every context reseeds itself from the shared entropy source every kReseedInterval requests,
+ * and after fork() in the child process before the first use.
+ *
+ * @note Contexts are leased instead of being thread_local, because thread_local is enabled
+ *       only for the multi-threaded Pythia build (see VIRGIL_THREAD_LOCAL), and a thread_local context
+ *       would be seeded by every short-living thread, while leased ones are reused across threads.
+ */
+class VirgilRandomPool {
+public:
+    /**
+     * @brief Number of random requests after which a context is reseeded.
+     */
+    static constexpr int kReseedInterval = 10000;
+    /**
+     * @brief Maximum number of idle contexts that are kept for the future leases.
+     */
+    static constexpr size_t kIdleContextsMax = 64;
+
+    /**
+     * @brief Opaque pooled context.
+     */
+    struct Entry;
+
+    /**
+     * @brief Exclusive ownership of the pooled context, it is returned to the pool on destruction.
+     */
+    class Lease {
+    public:
+        /**
+         * @brief Create empty lease.
+         */
+        Lease() noexcept;
+
+        /**
+         * @brief Return ready to use context.
+         * @throw VirgilCryptoException, if lease is empty or context reseeding failed.
+         */
+        mbedtls_ctr_drbg_context* get();
+
+        /**
+         * @brief Return true if lease holds a context.
+         */
+        explicit operator bool() const noexcept;
+
+    public:
+        //! @cond Doxygen_Suppress
+        Lease(Lease&& rhs) noexcept;
+
+        Lease& operator=(Lease&& rhs) noexcept;
+
+        ~Lease() noexcept;
+        //! @endcond
+
+    private:
+        explicit Lease(std::unique_ptr<Entry> entry) noexcept;
+
+        void release() noexcept;
+
+    private:
+        std::unique_ptr<Entry> entry_;
+
+        friend class VirgilRandomPool;
+    };
+
+public:
+    /**
+     * @brief Take seeded context from the pool, or create a new one if the pool is empty.
+     */
+    static Lease acquire();
+
+    /**
+     * @brief Take seeded context from the pool and mix given personalization data into it.
+     */
+    static Lease acquire(const virgil::crypto::VirgilByteArray& personalInfo);
+
+    /**
+     * @brief Return number of idle contexts that are waiting in the pool.
+     */
+    static size_t idleCount();
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_RANDOM_POOL_H */
@@ -0,0 +1,175 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilScratchArena.h"
+
+#include <limits>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+#include "VirgilConfig.h"
+#include "utils.h"
+
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::foundation::internal::VirgilScratchArena;
+
+constexpr size_t VirgilScratchArena::kBlockSizeMin;
+constexpr size_t VirgilScratchArena::kRetainedSizeMax;
+
+namespace {
+
+/**
+ * @brief Alignment of every allocation, it is enough for any fundamental type.
+ */
+constexpr size_t kAlignment = 16;
+
+VirgilScratchArena* thread_arena() {
+#if VIRGIL_CRYPTO_FEATURE_PYTHIA_MT
+    static thread_local VirgilScratchArena arena;
+    return &arena;
+#else
+    return nullptr;
+#endif
+}
+
+void zeroize(unsigned char* data, size_t size) noexcept {
+    volatile unsigned char* p = data;
+    while (size--) { *p++ = 0; }
+}
+
+} // namespace
+
+
+VirgilScratchArena::Scope::Scope()
+        : ownArena_(thread_arena() ? nullptr : std::make_unique<VirgilScratchArena>()),
+          arena_(ownArena_ ? *ownArena_ : *thread_arena()),
+          blockIndex_(arena_.current_),
+          blockUsed_(arena_.current_ < arena_.blocks_.size() ? arena_.blocks_[arena_.current_].used : 0) {
+    ++arena_.depth_;
+}
+
+VirgilScratchArena::Scope::~Scope() noexcept {
+    --arena_.depth_;
+    arena_.rewind(blockIndex_, blockUsed_);
+}
+
+unsigned char* VirgilScratchArena::Scope::allocate(size_t size) {
+    return arena_.allocate(size);
+}
+
+const VirgilScratchArena& VirgilScratchArena::Scope::arena() const noexcept {
+    return arena_;
+}
+
+size_t VirgilScratchArena::Scope::arraySize(size_t count, size_t size) {
+    if (size != 0 && count > std::numeric_limits<size_t>::max() / size) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Scratch allocation size is too big.");
+    }
+    return count * size;
+}
+
+
+VirgilScratchArena::VirgilScratchArena() noexcept : blocks_(), current_(0), depth_(0) {}
+
+VirgilScratchArena::~VirgilScratchArena() noexcept {
+    rewind(0, 0);
+}
+
+unsigned char* VirgilScratchArena::allocate(size_t size) {
+    const size_t alignedSize = (size + kAlignment - 1) & ~(kAlignment - 1);
+    if (alignedSize < size) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Scratch allocation size is too big.");
+    }
+
+    for (; current_ < blocks_.size(); ++current_) {
+        auto& block = blocks_[current_];
+        if (block.size - block.used >= alignedSize) {
+            auto result = block.data.get() + block.used;
+            block.used += alignedSize;
+            return result;
+        }
+    }
+
+    const size_t blockSize = alignedSize > kBlockSizeMin ? alignedSize : kBlockSizeMin;
+    blocks_.push_back(Block{ std::unique_ptr<unsigned char[]>(new unsigned char[blockSize]), blockSize, 0 });
+    current_ = blocks_.size() - 1;
+
+    auto& block = blocks_.back();
+    block.used = alignedSize;
+    return block.data.get();
+}
+
+size_t VirgilScratchArena::used() const noexcept {
+    size_t result = 0;
+    for (const auto& block : blocks_) {
+        result += block.used;
+    }
+    return result;
+}
+
+size_t VirgilScratchArena::capacity() const noexcept {
+    size_t result = 0;
+    for (const auto& block : blocks_) {
+        result += block.size;
+    }
+    return result;
+}
+
+void VirgilScratchArena::rewind(size_t blockIndex, size_t blockUsed) noexcept {
+    for (size_t index = blockIndex; index < blocks_.size(); ++index) {
+        auto& block = blocks_[index];
+        const size_t keptUsed = index == blockIndex ? blockUsed : 0;
+        if (block.used > keptUsed) {
+            zeroize(block.data.get() + keptUsed, block.used - keptUsed);
+            block.used = keptUsed;
+        }
+    }
+    current_ = blockIndex;
+
+    if (depth_ > 0) {
+        return;
+    }
+
+    size_t retainedSize = 0;
+    auto retainedEnd = blocks_.begin();
+    while (retainedEnd != blocks_.end() && retainedSize + retainedEnd->size <= kRetainedSizeMax) {
+        retainedSize += retainedEnd->size;
+        ++retainedEnd;
+    }
+    blocks_.erase(retainedEnd, blocks_.end());
+    current_ = 0;
+}
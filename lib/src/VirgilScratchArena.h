@@ -0,0 +1,158 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_SCRATCH_ARENA_H
+#define VIRGIL_CRYPTO_SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief Bump allocator for short-living scratch buffers of a single operation.
+ *
+ * Memory is allocated within a Scope only. When scope ends, everything allocated within it
+ *     is zeroized in bulk and becomes available again, so steady-state scratch buffers need no heap allocations.
+ *     Scopes may be nested, inner scope releases only memory allocated within it.
+ *
+ * @note Every thread has own arena if thread_local is enabled (VIRGIL_CRYPTO_FEATURE_PYTHIA_MT),
+ *     otherwise every scope owns a temporary arena, so memory is still zeroized in bulk but is not reused.
+ */
+class VirgilScratchArena {
+public:
+    /**
+     * @brief Minimum size of the block requested from the heap.
+     */
+    static constexpr size_t kBlockSizeMin = 4 * 1024;
+    /**
+     * @brief Maximum size of the blocks kept for the next operation, when outermost scope ends.
+     */
+    static constexpr size_t kRetainedSizeMax = 64 * 1024;
+
+    /**
+     * @brief Scratch memory of a single operation, released when scope object is destroyed.
+     */
+    class Scope {
+    public:
+        /**
+         * @brief Start scope within current thread arena.
+         */
+        Scope();
+
+        /**
+         * @brief Zeroize and release all memory allocated within this scope.
+         */
+        ~Scope() noexcept;
+
+        /**
+         * @brief Allocate uninitialized memory suitably aligned for any fundamental type.
+         * @return Pointer to the memory that is valid until the scope ends.
+         */
+        unsigned char* allocate(size_t size);
+
+        /**
+         * @brief Allocate uninitialized array of trivially destructible objects.
+         * @see allocate(size_t)
+         */
+        template<typename T>
+        T* allocateArray(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "Scratch memory is released without destruction.");
+            return reinterpret_cast<T*>(allocate(arraySize(count, sizeof(T))));
+        }
+
+        /**
+         * @brief Return arena this scope allocates from.
+         */
+        const VirgilScratchArena& arena() const noexcept;
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        static size_t arraySize(size_t count, size_t size);
+
+    private:
+        std::unique_ptr<VirgilScratchArena> ownArena_;
+        VirgilScratchArena& arena_;
+        const size_t blockIndex_;
+        const size_t blockUsed_;
+    };
+
+    VirgilScratchArena() noexcept;
+
+    ~VirgilScratchArena() noexcept;
+
+    /**
+     * @brief Return number of bytes allocated within all active scopes.
+     */
+    size_t used() const noexcept;
+
+    /**
+     * @brief Return total size of the blocks owned by arena.
+     */
+    size_t capacity() const noexcept;
+
+    VirgilScratchArena(const VirgilScratchArena&) = delete;
+
+    VirgilScratchArena& operator=(const VirgilScratchArena&) = delete;
+
+private:
+    unsigned char* allocate(size_t size);
+
+    /**
+     * @brief Zeroize and release memory allocated after the given position.
+     */
+    void rewind(size_t blockIndex, size_t blockUsed) noexcept;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+        size_t used;
+    };
+
+    std::vector<Block> blocks_;
+    size_t current_;
+    size_t depth_;
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_SCRATCH_ARENA_H */
@@ -0,0 +1,251 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilSecureByteArray.h"
+
+#include <map>
+#include <mutex>
+#include <new>
+
+#if defined(_WIN32)
+#   include <windows.h>
+#   define VIRGIL_SECURE_MEMORY_WIN32 1
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#   include <sys/mman.h>
+#   include <unistd.h>
+#   define VIRGIL_SECURE_MEMORY_POSIX 1
+#endif
+
+using virgil::crypto::foundation::internal::VirgilSecureMemory;
+using virgil::crypto::foundation::internal::VirgilSecureByteArray;
+
+constexpr size_t VirgilSecureMemory::kSlabSize;
+constexpr size_t VirgilSecureMemory::kSlotSizeMax;
+
+namespace {
+
+constexpr size_t kSlotSizeMin = 32;
+constexpr size_t kSlotClassesNum = 8; // 32, 64, ..., 4096
+
+static_assert((kSlotSizeMin << (kSlotClassesNum - 1)) == VirgilSecureMemory::kSlotSizeMax,
+        "Slot classes MUST cover all sizes up to kSlotSizeMax");
+
+void zeroize(void* data, size_t size) noexcept {
+    volatile unsigned char* p = static_cast<unsigned char*>(data);
+    while (size--) { *p++ = 0; }
+}
+
+size_t slot_class(size_t size) noexcept {
+    size_t slotClass = 0;
+    while ((kSlotSizeMin << slotClass) < size) {
+        ++slotClass;
+    }
+    return slotClass;
+}
+
+size_t round_to_pages(size_t size) {
+#if VIRGIL_SECURE_MEMORY_POSIX
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#elif VIRGIL_SECURE_MEMORY_WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const size_t pageSize = systemInfo.dwPageSize;
+#else
+    const size_t pageSize = 4096;
+#endif
+    const size_t roundedSize = (size + pageSize - 1) / pageSize * pageSize;
+    if (roundedSize < size) {
+        throw std::bad_alloc();
+    }
+    return roundedSize;
+}
+
+/**
+ * @brief Allocate region of pages and try to lock it in RAM.
+ */
+unsigned char* map_region(size_t size, bool& isLocked) {
+#if VIRGIL_SECURE_MEMORY_POSIX
+    void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    isLocked = mlock(region, size) == 0;
+#   if defined(MADV_DONTDUMP)
+    (void)madvise(region, size, MADV_DONTDUMP);
+#   endif
+    return static_cast<unsigned char*>(region);
+#elif VIRGIL_SECURE_MEMORY_WIN32
+    void* region = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (region == nullptr) {
+        throw std::bad_alloc();
+    }
+    isLocked = VirtualLock(region, size) != 0;
+    return static_cast<unsigned char*>(region);
+#else
+    isLocked = false;
+    return new unsigned char[size];
+#endif
+}
+
+void unmap_region(unsigned char* region, size_t size, bool isLocked) noexcept {
+#if VIRGIL_SECURE_MEMORY_POSIX
+    if (isLocked) {
+        (void)munlock(region, size);
+    }
+    (void)munmap(region, size);
+#elif VIRGIL_SECURE_MEMORY_WIN32
+    if (isLocked) {
+        (void)VirtualUnlock(region, size);
+    }
+    (void)VirtualFree(region, 0, MEM_RELEASE);
+#else
+    (void)size;
+    (void)isLocked;
+    delete[] region;
+#endif
+}
+
+/**
+ * @brief Shared state of the secure memory.
+ * @note It is never destroyed, so secure containers held by static objects can be safely freed at exit.
+ */
+class SecureMemoryState {
+public:
+    std::mutex mutex;
+    std::vector<unsigned char*> freeSlots[kSlotClassesNum];
+    std::map<unsigned char*, bool> largeRegions; ///< region -> is locked
+    size_t lockedSize = 0;
+
+    void addSlab(size_t slotClass) {
+        const size_t slotSize = kSlotSizeMin << slotClass;
+        auto& slots = freeSlots[slotClass];
+        // Free list MUST never reallocate on deallocation, so it is reserved for all slots at once.
+        slots.reserve(slots.capacity() + VirgilSecureMemory::kSlabSize / slotSize);
+
+        bool isLocked = false;
+        auto slab = map_region(VirgilSecureMemory::kSlabSize, isLocked);
+        if (isLocked) {
+            lockedSize += VirgilSecureMemory::kSlabSize;
+        }
+        for (size_t offset = VirgilSecureMemory::kSlabSize; offset > 0; offset -= slotSize) {
+            slots.push_back(slab + offset - slotSize);
+        }
+    }
+};
+
+SecureMemoryState& memory_state() {
+    static SecureMemoryState* state = new SecureMemoryState();
+    return *state;
+}
+
+} // namespace
+
+
+void* VirgilSecureMemory::allocate(size_t size) {
+    auto& state = memory_state();
+
+    if (size > kSlotSizeMax) {
+        const size_t regionSize = round_to_pages(size);
+        bool isLocked = false;
+        auto region = map_region(regionSize, isLocked);
+        std::lock_guard<std::mutex> lock(state.mutex);
+        try {
+            state.largeRegions.emplace(region, isLocked);
+        } catch (...) {
+            unmap_region(region, regionSize, isLocked);
+            throw;
+        }
+        if (isLocked) {
+            state.lockedSize += regionSize;
+        }
+        return region;
+    }
+
+    const size_t slotClass = slot_class(size);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto& slots = state.freeSlots[slotClass];
+    if (slots.empty()) {
+        state.addSlab(slotClass);
+    }
+    auto slot = slots.back();
+    slots.pop_back();
+    return slot;
+}
+
+void VirgilSecureMemory::deallocate(void* data, size_t size) noexcept {
+    if (data == nullptr) {
+        return;
+    }
+
+    auto& state = memory_state();
+    auto bytes = static_cast<unsigned char*>(data);
+
+    if (size > kSlotSizeMax) {
+        const size_t regionSize = round_to_pages(size);
+        zeroize(bytes, regionSize);
+        bool isLocked = false;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            auto found = state.largeRegions.find(bytes);
+            isLocked = found->second;
+            state.largeRegions.erase(found);
+            if (isLocked) {
+                state.lockedSize -= regionSize;
+            }
+        }
+        unmap_region(bytes, regionSize, isLocked);
+        return;
+    }
+
+    const size_t slotClass = slot_class(size);
+    zeroize(bytes, kSlotSizeMin << slotClass);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.freeSlots[slotClass].push_back(bytes);
+}
+
+size_t VirgilSecureMemory::lockedSize() {
+    auto& state = memory_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.lockedSize;
+}
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+void bytes_zeroize(VirgilSecureByteArray& array) noexcept {
+    zeroize(array.data(), array.size());
+}
+
+}}}}
@@ -0,0 +1,156 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_SECURE_BYTE_ARRAY_H
+#define VIRGIL_CRYPTO_SECURE_BYTE_ARRAY_H
+
+#include <cstddef>
+#include <vector>
+
+#include <virgil/crypto/VirgilByteArray.h>
+
+namespace virgil { namespace crypto { namespace foundation { namespace internal {
+
+/**
+ * @brief Process-wide pool of memory for the key material.
+ *
+ * Memory is taken from big slabs that are locked in RAM once (mlock / VirtualLock),
+ * so secrets are never written to swap and locking costs no syscall per buffer.
+ * Slabs are split to slots of the fixed sizes, and every slot is zeroized when it is freed.
+ * Allocations bigger than kSlotSizeMax get a dedicated locked mapping.
+ *
+ * @note If memory can not be locked (i.e. RLIMIT_MEMLOCK is exceeded) it is used unlocked,
+ *       zeroization is guaranteed anyway.
+ */
+class VirgilSecureMemory {
+public:
+    /**
+     * @brief Size of the slab that is locked at once.
+     */
+    static constexpr size_t kSlabSize = 64 * 1024;
+    /**
+     * @brief Maximum allocation size that is served from the slabs.
+     */
+    static constexpr size_t kSlotSizeMax = 4096;
+
+    /**
+     * @brief Allocate memory, it is aligned for any fundamental type.
+     * @throw std::bad_alloc, if memory can not be allocated.
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * @brief Zeroize and free memory allocated by allocate().
+     * @param size - the same size that was passed to the allocate().
+     */
+    static void deallocate(void* data, size_t size) noexcept;
+
+    /**
+     * @brief Return number of bytes that are currently locked in RAM.
+     */
+    static size_t lockedSize();
+};
+
+/**
+ * @brief Standard allocator that takes memory from the VirgilSecureMemory.
+ */
+template<typename T>
+class VirgilSecureAllocator {
+public:
+    using value_type = T;
+
+    VirgilSecureAllocator() noexcept = default;
+
+    template<typename U>
+    VirgilSecureAllocator(const VirgilSecureAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(VirgilSecureMemory::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* data, size_t n) noexcept {
+        VirgilSecureMemory::deallocate(data, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const VirgilSecureAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const VirgilSecureAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+/**
+ * @brief Byte array for the key material: it is locked in RAM and zeroized when freed.
+ */
+using VirgilSecureByteArray = std::vector<unsigned char, VirgilSecureAllocator<unsigned char>>;
+
+/**
+ * @brief Make all bytes zero, capacity is kept.
+ */
+void bytes_zeroize(VirgilSecureByteArray& array) noexcept;
+
+/**
+ * @brief Plain copy of the secure bytes for the interfaces that accept VirgilByteArray only.
+ *
+ * Copy is zeroized on destruction, so it SHOULD be kept only for the duration of the call.
+ */
+class VirgilSecureBytesCopy {
+public:
+    explicit VirgilSecureBytesCopy(const VirgilSecureByteArray& src) : bytes_(src.cbegin(), src.cend()) {}
+
+    ~VirgilSecureBytesCopy() noexcept {
+        virgil::crypto::bytes_zeroize(bytes_);
+    }
+
+    const virgil::crypto::VirgilByteArray& get() const noexcept {
+        return bytes_;
+    }
+
+    VirgilSecureBytesCopy(const VirgilSecureBytesCopy&) = delete;
+
+    VirgilSecureBytesCopy& operator=(const VirgilSecureBytesCopy&) = delete;
+
+private:
+    virgil::crypto::VirgilByteArray bytes_;
+};
+
+}}}}
+
+#endif /* VIRGIL_CRYPTO_SECURE_BYTE_ARRAY_H */
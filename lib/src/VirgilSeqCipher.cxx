@@ -36,6 +36,11 @@
 
 #include <virgil/crypto/VirgilSeqCipher.h>
 
+#include <algorithm>
+#include <cstring>
+
+#include <mbedtls/cipher.h>
+
 #include <virgil/crypto/VirgilCryptoError.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
@@ -50,6 +55,86 @@ using virgil::crypto::foundation::VirgilSymmetricCipher;
 
 using virgil::crypto::make_error;
 
+namespace virgil { namespace crypto { namespace internal {
+
+//! Maximum block size of the supported symmetric ciphers.
+constexpr size_t kBlockSizeMax = 16;
+static_assert(kBlockSizeMax == MBEDTLS_MAX_BLOCK_LENGTH, "Maximum block size mismatch.");
+
+//! Maximum size of the data that is processed within intermediate buffer at once.
+constexpr size_t kScratchPieceSize = 1024;
+
+/**
+ * @brief Writes processed data to the output segments sequentially.
+ *
+ * Data is processed directly to the current segment while it has enough space,
+ *     otherwise it is processed to the small intermediate buffer and then scattered.
+ */
+class SegmentWriter {
+public:
+    SegmentWriter(const VirgilSeqCipher::OutputSegment* outputs, size_t outputsNum)
+            : outputs_(outputs), outputsNum_(outputsNum), index_(0), offset_(0), written_(0) {
+    }
+
+    void update(VirgilSymmetricCipher& symmetricCipher, const unsigned char* data, size_t dataSize) {
+        while (dataSize > 0) {
+            const size_t available = available_size();
+            size_t pieceSize = 0;
+            if (available > kBlockSizeMax) {
+                pieceSize = std::min(dataSize, available - kBlockSizeMax);
+                advance(symmetricCipher.update(data, pieceSize, outputs_[index_].data + offset_, available));
+            } else {
+                pieceSize = std::min(dataSize, kScratchPieceSize);
+                unsigned char scratch[kScratchPieceSize + kBlockSizeMax];
+                scatter(scratch, symmetricCipher.update(data, pieceSize, scratch, sizeof(scratch)));
+            }
+            data += pieceSize;
+            dataSize -= pieceSize;
+        }
+    }
+
+    size_t written() const {
+        return written_;
+    }
+
+private:
+    size_t available_size() {
+        while (index_ < outputsNum_ && offset_ == outputs_[index_].size) {
+            ++index_;
+            offset_ = 0;
+        }
+        return index_ < outputsNum_ ? outputs_[index_].size - offset_ : 0;
+    }
+
+    void advance(size_t size) {
+        offset_ += size;
+        written_ += size;
+    }
+
+    void scatter(const unsigned char* data, size_t dataSize) {
+        while (dataSize > 0) {
+            const size_t available = available_size();
+            if (available == 0) {
+                throw make_error(VirgilCryptoError::InvalidArgument, "Output segments are too small.");
+            }
+            const size_t copySize = std::min(dataSize, available);
+            std::memcpy(outputs_[index_].data + offset_, data, copySize);
+            advance(copySize);
+            data += copySize;
+            dataSize -= copySize;
+        }
+    }
+
+private:
+    const VirgilSeqCipher::OutputSegment* outputs_;
+    const size_t outputsNum_;
+    size_t index_;
+    size_t offset_;
+    size_t written_;
+};
+
+}}}
+
 VirgilByteArray VirgilSeqCipher::startEncryption() {
 
     initEncryption();
@@ -88,10 +173,22 @@ VirgilByteArray VirgilSeqCipher::process(const VirgilByteArray& data) {
         return getSymmetricCipher().update(data);
 
     } else {
-        VirgilByteArray payload = filterAndSetupContentInfo(data, false);
+        VirgilByteArray heldData;
+        const size_t payloadOffset = filterAndSetupContentInfo(data.data(), data.size(), false, heldData);
 
         if (isReadyForDecryption()) {
-            return getSymmetricCipher().update(payload);
+            auto& symmetricCipher = getSymmetricCipher();
+            const size_t payloadSize = data.size() - payloadOffset;
+            VirgilByteArray plainText(heldData.size() + payloadSize + 2 * symmetricCipher.blockSize());
+            size_t plainTextSize = 0;
+            if (!heldData.empty()) {
+                plainTextSize += symmetricCipher.update(
+                        heldData.data(), heldData.size(), plainText.data(), plainText.size());
+            }
+            plainTextSize += symmetricCipher.update(data.data() + payloadOffset, payloadSize,
+                    plainText.data() + plainTextSize, plainText.size() - plainTextSize);
+            plainText.resize(plainTextSize);
+            return plainText;
         }
     }
 
@@ -99,6 +196,54 @@ VirgilByteArray VirgilSeqCipher::process(const VirgilByteArray& data) {
 }
 
 
+size_t VirgilSeqCipher::processvOutputSize(size_t dataSize) {
+    // Up to the block can be buffered by the cipher, and the same by the content info filter
+    return dataSize + 2 * internal::kBlockSizeMax;
+}
+
+
+size_t VirgilSeqCipher::processv(
+        const InputSegment* inputs, size_t inputsNum, const OutputSegment* outputs, size_t outputsNum) {
+
+    if (!isInited()) {
+        throw make_error(VirgilCryptoError::InvalidState,
+            "VirgilSeqCipher::processv() can not be called before any 'start' function is called.");
+    }
+
+    size_t inputSize = 0;
+    for (size_t i = 0; i < inputsNum; ++i) {
+        inputSize += inputs[i].size;
+    }
+    size_t outputSize = 0;
+    for (size_t i = 0; i < outputsNum; ++i) {
+        outputSize += outputs[i].size;
+    }
+    if (outputSize < processvOutputSize(inputSize)) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Output segments are too small.");
+    }
+
+    auto disposer = ScopeGuardOnException([this]() {
+        clear();
+    });
+
+    internal::SegmentWriter writer(outputs, outputsNum);
+    VirgilByteArray heldData;
+    for (size_t i = 0; i < inputsNum; ++i) {
+        const InputSegment& input = inputs[i];
+        if (isReadyForEncryption() || isReadyForDecryption()) {
+            writer.update(getSymmetricCipher(), input.data, input.size);
+            continue;
+        }
+        const size_t payloadOffset = filterAndSetupContentInfo(input.data, input.size, false, heldData);
+        if (isReadyForDecryption()) {
+            writer.update(getSymmetricCipher(), heldData.data(), heldData.size());
+            writer.update(getSymmetricCipher(), input.data + payloadOffset, input.size - payloadOffset);
+        }
+    }
+    return writer.written();
+}
+
+
 VirgilByteArray VirgilSeqCipher::finish() {
 
     auto disposer = ScopeGuard([this]() {
@@ -42,14 +42,39 @@
 
 using virgil::crypto::VirgilSigner;
 using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
 
 using virgil::crypto::foundation::VirgilHash;
 
 VirgilByteArray VirgilSigner::sign(
         const VirgilByteArray& data, const VirgilByteArray& privateKey, const VirgilByteArray& privateKeyPassword) {
 
+    return sign(data.data(), data.size(), privateKey, privateKeyPassword);
+}
+
+bool VirgilSigner::verify(const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilByteArray& publicKey) {
+
+    return verify(data.data(), data.size(), sign, publicKey);
+}
+
+VirgilByteArray VirgilSigner::sign(const VirgilByteArray& data, const VirgilPrivateKeyHandle& privateKey) {
+
+    return sign(data.data(), data.size(), privateKey);
+}
+
+bool VirgilSigner::verify(
+        const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilPublicKeyHandle& publicKey) {
+
+    return verify(data.data(), data.size(), sign, publicKey);
+}
+
+VirgilByteArray VirgilSigner::sign(
+        const unsigned char* data, size_t dataSize, const VirgilByteArray& privateKey,
+        const VirgilByteArray& privateKeyPassword) {
+
     // Calculate data digest
-    const auto digest = VirgilHash(getHashAlgorithm()).hash(data);
+    const auto digest = VirgilHash(getHashAlgorithm()).hash(data, dataSize);
 
     // Sign digest
     const auto signature = signHash(digest, privateKey, privateKeyPassword);
@@ -58,14 +83,44 @@ VirgilByteArray VirgilSigner::sign(
     return packSignature(signature);
 }
 
-bool VirgilSigner::verify(const VirgilByteArray& data, const VirgilByteArray& sign, const VirgilByteArray& publicKey) {
+bool VirgilSigner::verify(
+        const unsigned char* data, size_t dataSize, const VirgilByteArray& sign,
+        const VirgilByteArray& publicKey) {
+
+    // Unpack signature
+    const auto signature = unpackSignature(sign); // MUST be before getHashAlgorithm()
+
+    // Calculate data digest
+    VirgilHash hash(getHashAlgorithm());
+    const auto digest = hash.hash(data, dataSize);
+
+    // Verify signature
+    return verifyHash(digest, signature, publicKey);
+}
+
+VirgilByteArray VirgilSigner::sign(
+        const unsigned char* data, size_t dataSize, const VirgilPrivateKeyHandle& privateKey) {
+
+    // Calculate data digest
+    const auto digest = VirgilHash(getHashAlgorithm()).hash(data, dataSize);
+
+    // Sign digest
+    const auto signature = signHash(digest, privateKey);
+
+    // Pack signature
+    return packSignature(signature);
+}
+
+bool VirgilSigner::verify(
+        const unsigned char* data, size_t dataSize, const VirgilByteArray& sign,
+        const VirgilPublicKeyHandle& publicKey) {
 
     // Unpack signature
     const auto signature = unpackSignature(sign); // MUST be before getHashAlgorithm()
 
     // Calculate data digest
     VirgilHash hash(getHashAlgorithm());
-    const auto digest = hash.hash(data);
+    const auto digest = hash.hash(data, dataSize);
 
     // Verify signature
     return verifyHash(digest, signature, publicKey);
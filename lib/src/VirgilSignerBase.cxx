@@ -40,8 +40,12 @@
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Reader.h>
 #include <virgil/crypto/foundation/asn1/VirgilAsn1Writer.h>
 
+#include "VirgilKeyHandleImpl.h"
+
 using virgil::crypto::VirgilSignerBase;
 using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
 
 using virgil::crypto::foundation::VirgilHash;
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
@@ -67,6 +71,17 @@ bool VirgilSignerBase::verifyHash(
     return doVerifyHash(digest, signature, publicKey);
 }
 
+VirgilByteArray VirgilSignerBase::signHash(const VirgilByteArray& digest, const VirgilPrivateKeyHandle& privateKey) {
+    std::lock_guard<std::mutex> lock(privateKey.impl_->mutex);
+    return privateKey.impl_->cipher.sign(digest, hash_.type());
+}
+
+bool VirgilSignerBase::verifyHash(
+        const VirgilByteArray& digest, const VirgilByteArray& signature, const VirgilPublicKeyHandle& publicKey) {
+    std::lock_guard<std::mutex> lock(publicKey.impl_->mutex);
+    return publicKey.impl_->cipher.verify(digest, signature, hash_.type());
+}
+
 VirgilByteArray VirgilSignerBase::packSignature(const VirgilByteArray& signature) const {
     VirgilAsn1Writer asn1Writer;
     size_t asn1Len = 0;
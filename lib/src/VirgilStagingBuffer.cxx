@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include "VirgilStagingBuffer.h"
+
+#include <algorithm>
+#include <utility>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::internal::VirgilStagingBuffer;
+
+VirgilStagingBuffer::VirgilStagingBuffer(VirgilByteArray data) noexcept : buffer_(std::move(data)), offset_(0) {
+}
+
+void VirgilStagingBuffer::append(VirgilByteArray&& data) {
+    if (empty()) {
+        buffer_ = std::move(data);
+        offset_ = 0;
+    } else {
+        append(static_cast<const VirgilByteArray&>(data));
+    }
+}
+
+void VirgilStagingBuffer::append(const VirgilByteArray& data) {
+    compact();
+    buffer_.insert(buffer_.end(), data.cbegin(), data.cend());
+}
+
+size_t VirgilStagingBuffer::append(VirgilDataReader& reader, size_t maxSize) {
+    compact();
+    const size_t dataSize = buffer_.size();
+    buffer_.resize(dataSize + maxSize);
+    size_t readSize = 0;
+    try {
+        readSize = reader.readInto(buffer_.data() + dataSize, maxSize);
+    } catch (...) {
+        buffer_.resize(dataSize);
+        throw;
+    }
+    buffer_.resize(dataSize + std::min(readSize, maxSize));
+    return readSize;
+}
+
+const unsigned char* VirgilStagingBuffer::data() const noexcept {
+    return buffer_.data() + offset_;
+}
+
+size_t VirgilStagingBuffer::size() const noexcept {
+    return buffer_.size() - offset_;
+}
+
+bool VirgilStagingBuffer::empty() const noexcept {
+    return size() == 0;
+}
+
+void VirgilStagingBuffer::consume(size_t num) noexcept {
+    offset_ += std::min(num, size());
+}
+
+VirgilByteArray VirgilStagingBuffer::pop(size_t num) {
+    if (offset_ == 0 && num >= buffer_.size()) {
+        VirgilByteArray result;
+        result.swap(buffer_);
+        return result;
+    }
+    const size_t popSize = std::min(num, size());
+    VirgilByteArray result(data(), data() + popSize);
+    consume(popSize);
+    return result;
+}
+
+void VirgilStagingBuffer::clear() noexcept {
+    buffer_.clear();
+    offset_ = 0;
+}
+
+void VirgilStagingBuffer::compact() {
+    if (offset_ == 0) {
+        return;
+    }
+    if (empty()) {
+        clear();
+    } else if (offset_ >= size()) {
+        buffer_.erase(buffer_.begin(), buffer_.begin() + offset_);
+        offset_ = 0;
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#ifndef VIRGIL_CRYPTO_STAGING_BUFFER_H
+#define VIRGIL_CRYPTO_STAGING_BUFFER_H
+
+#include <cstddef>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilDataReader.h>
+
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief FIFO byte buffer used to assemble fixed size chunks from the reads of arbitrary size.
+ *
+ * Consumed bytes are not erased immediately, instead read offset is moved forward.
+ * Unread bytes are moved to the beginning of the storage only when consumed part
+ * is at least as big as unread one, so every byte is moved at most once on average,
+ * and cost of the buffering is linear regardless of the read size.
+ */
+class VirgilStagingBuffer {
+public:
+    /**
+     * @brief Create buffer that initially contains given data.
+     */
+    explicit VirgilStagingBuffer(VirgilByteArray data = VirgilByteArray()) noexcept;
+
+    /**
+     * @brief Append data to the end of the buffer.
+     * @note If buffer is empty, given data is taken without copying.
+     */
+    void append(VirgilByteArray&& data);
+
+    /**
+     * @brief Append data to the end of the buffer.
+     */
+    void append(const VirgilByteArray& data);
+
+    /**
+     * @brief Read up to maxSize bytes from the reader directly to the end of the buffer.
+     * @return Number of bytes that were read.
+     * @note Storage is reused, so no allocations are done when buffer is drained with the same pace.
+     */
+    size_t append(VirgilDataReader& reader, size_t maxSize);
+
+    /**
+     * @brief Return pointer to the first unread byte.
+     * @note Pointer is valid until next call of the method @link append() @endlink.
+     */
+    const unsigned char* data() const noexcept;
+
+    /**
+     * @brief Return number of unread bytes.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Return true if buffer has no unread bytes.
+     */
+    bool empty() const noexcept;
+
+    /**
+     * @brief Mark up to num bytes as read.
+     */
+    void consume(size_t num) noexcept;
+
+    /**
+     * @brief Return up to num unread bytes and mark them as read.
+     */
+    VirgilByteArray pop(size_t num);
+
+    /**
+     * @brief Drop all data.
+     */
+    void clear() noexcept;
+
+private:
+    /**
+     * @brief Move unread bytes to the beginning of the storage if it is cheap enough.
+     */
+    void compact();
+
+private:
+    VirgilByteArray buffer_;
+    size_t offset_;
+};
+
+}}}
+
+#endif /* VIRGIL_CRYPTO_STAGING_BUFFER_H */
@@ -41,16 +41,52 @@
 #include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
 
 #include "ScopeGuard.h"
+#include "VirgilDataIO.h"
+#include "VirgilPipeline.h"
 
 using virgil::crypto::VirgilStreamCipher;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilDataSource;
 using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilDataWriter;
 
 using virgil::crypto::foundation::VirgilKDF;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
 using virgil::crypto::foundation::VirgilAsymmetricCipher;
 
+namespace virgil { namespace crypto { namespace internal {
+
+/**
+ * @brief Decrypt held data followed by the payload to the given buffer.
+ * @return Size of the decrypted data, buffer is only enlarged if needed.
+ */
+static size_t decrypt_payload(
+        VirgilSymmetricCipher& symmetricCipher, const VirgilByteArray& heldData,
+        const unsigned char* payload, size_t payloadSize, VirgilByteArray& decryptedData) {
+    const size_t decryptedDataSizeMax = heldData.size() + payloadSize + 2 * symmetricCipher.blockSize();
+    if (decryptedData.size() < decryptedDataSizeMax) {
+        decryptedData.resize(decryptedDataSizeMax);
+    }
+    size_t decryptedDataSize = 0;
+    if (!heldData.empty()) {
+        decryptedDataSize += symmetricCipher.update(
+                heldData.data(), heldData.size(), decryptedData.data(), decryptedData.size());
+    }
+    decryptedDataSize += symmetricCipher.update(payload, payloadSize,
+            decryptedData.data() + decryptedDataSize, decryptedData.size() - decryptedDataSize);
+    return decryptedDataSize;
+}
+
+}}}
+
+void VirgilStreamCipher::setPipelineDepth(size_t depth) {
+    pipelineDepth_ = depth;
+}
+
+size_t VirgilStreamCipher::getPipelineDepth() const {
+    return pipelineDepth_;
+}
+
 void VirgilStreamCipher::encrypt(VirgilDataSource& source, VirgilDataSink& sink, bool embedContentInfo) {
 
     auto disposer = ScopeGuard([this]() {
@@ -65,11 +101,29 @@ void VirgilStreamCipher::encrypt(VirgilDataSource& source, VirgilDataSink& sink,
         VirgilDataSink::safeWrite(sink, getContentInfo());
     }
 
-    while (source.hasData() && sink.isGood()) {
-        VirgilDataSink::safeWrite(sink, getSymmetricCipher().update(source.read()));
+    auto& symmetricCipher = getSymmetricCipher();
+
+    auto reader = internal::as_data_reader(source);
+    auto writer = internal::as_data_writer(sink);
+    if (pipelineDepth_ == 0 && reader != nullptr && writer != nullptr) {
+        VirgilByteArray data(internal::kDataBufferSize);
+        VirgilByteArray encryptedData(internal::kDataBufferSize + symmetricCipher.blockSize());
+        while (reader->hasData() && writer->isGood()) {
+            const size_t dataSize = reader->readInto(data.data(), data.size());
+            const size_t encryptedDataSize = symmetricCipher.update(
+                    data.data(), dataSize, encryptedData.data(), encryptedData.size());
+            VirgilDataWriter::safeWrite(*writer, encryptedData.data(), encryptedDataSize);
+        }
+    } else {
+        internal::pipeline_transform(source, sink, pipelineDepth_,
+            [&symmetricCipher](const VirgilByteArray& data, VirgilByteArray& encryptedData) {
+                encryptedData.resize(data.size() + symmetricCipher.blockSize());
+                encryptedData.resize(symmetricCipher.update(
+                        data.data(), data.size(), encryptedData.data(), encryptedData.size()));
+            });
     }
 
-    VirgilDataSink::safeWrite(sink, getSymmetricCipher().finish());
+    VirgilDataSink::safeWrite(sink, symmetricCipher.finish());
 }
 
 
@@ -100,15 +154,41 @@ void VirgilStreamCipher::decrypt(VirgilDataSource& source, VirgilDataSink& sink)
         clear();
     });
 
-    while (source.hasData() && sink.isGood()) {
-        VirgilByteArray payload = filterAndSetupContentInfo(source.read(), false);
-
-        if (isReadyForDecryption()) {
-            VirgilDataSink::safeWrite(sink, getSymmetricCipher().update(payload));
-        }
+    auto reader = internal::as_data_reader(source);
+    auto writer = internal::as_data_writer(sink);
+    if (pipelineDepth_ == 0 && reader != nullptr && writer != nullptr) {
+        decryptBuffered(*reader, *writer);
+    } else {
+        internal::pipeline_transform(source, sink, pipelineDepth_,
+            [this](const VirgilByteArray& data, VirgilByteArray& decryptedData) {
+                VirgilByteArray heldData;
+                const size_t payloadOffset = filterAndSetupContentInfo(data.data(), data.size(), false, heldData);
+
+                if (isReadyForDecryption()) {
+                    decryptedData.resize(internal::decrypt_payload(getSymmetricCipher(), heldData,
+                            data.data() + payloadOffset, data.size() - payloadOffset, decryptedData));
+                }
+            });
     }
 
     VirgilByteArray payload = filterAndSetupContentInfo(VirgilByteArray(), true);
     VirgilDataSink::safeWrite(sink, getSymmetricCipher().update(payload));
     VirgilDataSink::safeWrite(sink, getSymmetricCipher().finish());
 }
+
+
+void VirgilStreamCipher::decryptBuffered(VirgilDataReader& reader, VirgilDataWriter& writer) {
+    VirgilByteArray data(internal::kDataBufferSize);
+    VirgilByteArray heldData;
+    VirgilByteArray decryptedData;
+    while (reader.hasData() && writer.isGood()) {
+        const size_t dataSize = reader.readInto(data.data(), data.size());
+        const size_t payloadOffset = filterAndSetupContentInfo(data.data(), dataSize, false, heldData);
+
+        if (isReadyForDecryption()) {
+            const size_t decryptedDataSize = internal::decrypt_payload(getSymmetricCipher(), heldData,
+                    data.data() + payloadOffset, dataSize - payloadOffset, decryptedData);
+            VirgilDataWriter::safeWrite(writer, decryptedData.data(), decryptedDataSize);
+        }
+    }
+}
@@ -0,0 +1,302 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#include <virgil/crypto/VirgilStreamSignCipher.h>
+
+#include <algorithm>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+#include <virgil/crypto/VirgilCryptoException.h>
+#include <virgil/crypto/VirgilDataSourceReader.h>
+#include <virgil/crypto/VirgilDataSinkWriter.h>
+#include <virgil/crypto/VirgilSignerBase.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
+
+#include "ScopeGuard.h"
+#include "VirgilDataIO.h"
+#include "utils.h"
+
+using virgil::crypto::VirgilStreamSignCipher;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataSource;
+using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilDataReader;
+using virgil::crypto::VirgilDataWriter;
+using virgil::crypto::VirgilDataSourceReader;
+using virgil::crypto::VirgilDataSinkWriter;
+using virgil::crypto::VirgilSignerBase;
+using virgil::crypto::VirgilCryptoException;
+
+using virgil::crypto::foundation::VirgilHash;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
+
+/**
+ * @name Contsants
+ */
+///@{
+static const char* const kCustomParameterKey_SignatureHash = "signatureHash";
+static const char* const kCustomParameterKey_Signature = "signature";
+static const char* const kCustomParameterKey_SignatureTrailer = "signatureTrailer";
+static const int kSignatureTrailer_Enabled = 1;
+//! Maximum size of the packed signature that can be stored as trailer.
+static const size_t kSignatureSizeMax = 8 * 1024;
+//! Size of the big-endian signature size that terminates trailer.
+static const size_t kSignatureSizeLength = 4;
+///@}
+
+/**
+ * @brief Signer that gives access to the signature packing.
+ */
+class VirgilStreamSignCipher::Impl : public VirgilSignerBase {
+public:
+    explicit Impl(VirgilHash::Algorithm hashAlgorithm) : VirgilSignerBase(hashAlgorithm) {}
+
+    using VirgilSignerBase::packSignature;
+    using VirgilSignerBase::unpackSignature;
+};
+
+VirgilStreamSignCipher::VirgilStreamSignCipher(VirgilHash::Algorithm hashAlgorithm)
+        : impl_(std::make_unique<Impl>(hashAlgorithm)) {
+}
+
+VirgilStreamSignCipher::VirgilStreamSignCipher(VirgilStreamSignCipher&& rhs) noexcept = default;
+
+VirgilStreamSignCipher& VirgilStreamSignCipher::operator=(VirgilStreamSignCipher&& rhs) noexcept = default;
+
+VirgilStreamSignCipher::~VirgilStreamSignCipher() noexcept = default;
+
+void VirgilStreamSignCipher::encrypt(
+        VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& privateKey,
+        const VirgilByteArray& privateKeyPassword, bool embedContentInfo) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    initEncryption();
+
+    VirgilHash hash(impl_->getHashAlgorithm());
+    customParams().setString(str2bytes(kCustomParameterKey_SignatureHash), str2bytes(hash.name()));
+    customParams().removeData(str2bytes(kCustomParameterKey_Signature));
+    if (embedContentInfo) {
+        customParams().setInteger(str2bytes(kCustomParameterKey_SignatureTrailer), kSignatureTrailer_Enabled);
+    } else {
+        customParams().removeInteger(str2bytes(kCustomParameterKey_SignatureTrailer));
+    }
+
+    buildContentInfo();
+
+    if (embedContentInfo) {
+        VirgilDataSink::safeWrite(sink, getContentInfo());
+    }
+
+    VirgilDataSourceReader sourceReader(source);
+    VirgilDataSinkWriter sinkWriter(sink);
+    auto reader = internal::as_data_reader(source);
+    auto writer = internal::as_data_writer(sink);
+    if (reader == nullptr) {
+        reader = &sourceReader;
+    }
+    if (writer == nullptr) {
+        writer = &sinkWriter;
+    }
+
+    auto& symmetricCipher = getSymmetricCipher();
+
+    // Hash and encrypt within the same pass
+    hash.start();
+    VirgilByteArray data(internal::kDataBufferSize);
+    VirgilByteArray encryptedData(internal::kDataBufferSize + symmetricCipher.blockSize());
+    while (reader->hasData() && writer->isGood()) {
+        const size_t dataSize = reader->readInto(data.data(), data.size());
+        hash.update(data.data(), dataSize);
+        const size_t encryptedDataSize = symmetricCipher.update(
+                data.data(), dataSize, encryptedData.data(), encryptedData.size());
+        VirgilDataWriter::safeWrite(*writer, encryptedData.data(), encryptedDataSize);
+    }
+    VirgilDataSink::safeWrite(sink, symmetricCipher.finish());
+
+    // Sign
+    const VirgilByteArray signature = impl_->packSignature(
+            impl_->signHash(hash.finish(), privateKey, privateKeyPassword));
+
+    if (embedContentInfo) {
+        if (signature.size() > kSignatureSizeMax) {
+            throw make_error(VirgilCryptoError::InvalidState, "Signature is too big to be stored as trailer.");
+        }
+        VirgilByteArray trailer(signature);
+        for (size_t i = kSignatureSizeLength; i > 0; --i) {
+            trailer.push_back(static_cast<unsigned char>((signature.size() >> (8 * (i - 1))) & 0xFF));
+        }
+        VirgilDataSink::safeWrite(sink, trailer);
+    } else {
+        customParams().setData(str2bytes(kCustomParameterKey_Signature), signature);
+    }
+}
+
+bool VirgilStreamSignCipher::decryptWithKey(
+        VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& recipientId,
+        const VirgilByteArray& privateKey, const VirgilByteArray& signerPublicKey,
+        const VirgilByteArray& privateKeyPassword) {
+
+    initDecryptionWithKey(recipientId, privateKey, privateKeyPassword);
+
+    return decryptAndVerify(source, sink, signerPublicKey);
+}
+
+bool VirgilStreamSignCipher::decryptWithPassword(
+        VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& pwd,
+        const VirgilByteArray& signerPublicKey) {
+
+    initDecryptionWithPassword(pwd);
+
+    return decryptAndVerify(source, sink, signerPublicKey);
+}
+
+bool VirgilStreamSignCipher::decryptAndVerify(
+        VirgilDataSource& source, VirgilDataSink& sink, const VirgilByteArray& signerPublicKey) {
+
+    auto disposer = ScopeGuard([this]() {
+        clear();
+    });
+
+    VirgilDataSourceReader sourceReader(source);
+    VirgilDataSinkWriter sinkWriter(sink);
+    auto reader = internal::as_data_reader(source);
+    auto writer = internal::as_data_writer(sink);
+    if (reader == nullptr) {
+        reader = &sourceReader;
+    }
+    if (writer == nullptr) {
+        writer = &sinkWriter;
+    }
+
+    std::unique_ptr<VirgilHash> hash;
+    bool hasSignatureTrailer = false;
+    VirgilByteArray heldData; // Possible signature trailer
+    VirgilByteArray decryptedData;
+
+    // Decrypt, hash and write
+    const auto decryptData = [&](const unsigned char* payload, size_t payloadSize) {
+        if (payloadSize == 0) {
+            return;
+        }
+        auto& symmetricCipher = getSymmetricCipher();
+        if (decryptedData.size() < payloadSize + symmetricCipher.blockSize()) {
+            decryptedData.resize(payloadSize + symmetricCipher.blockSize());
+        }
+        const size_t decryptedDataSize = symmetricCipher.update(
+                payload, payloadSize, decryptedData.data(), decryptedData.size());
+        hash->update(decryptedData.data(), decryptedDataSize);
+        VirgilDataWriter::safeWrite(*writer, decryptedData.data(), decryptedDataSize);
+    };
+
+    // Hold back data that can be signature trailer, and decrypt the rest
+    const auto consumeData = [&](const unsigned char* payload, size_t payloadSize) {
+        if (!hash) {
+            hash = std::make_unique<VirgilHash>(
+                    bytes2str(customParams().getString(str2bytes(kCustomParameterKey_SignatureHash))));
+            hash->start();
+            try {
+                hasSignatureTrailer = customParams().getInteger(
+                        str2bytes(kCustomParameterKey_SignatureTrailer)) == kSignatureTrailer_Enabled;
+            } catch (const VirgilCryptoException&) {
+                hasSignatureTrailer = false;
+            }
+        }
+        if (!hasSignatureTrailer) {
+            decryptData(payload, payloadSize);
+            return;
+        }
+        constexpr size_t kHeldDataSizeMax = kSignatureSizeMax + kSignatureSizeLength;
+        if (heldData.size() + payloadSize > kHeldDataSizeMax) {
+            const size_t releaseSize = heldData.size() + payloadSize - kHeldDataSizeMax;
+            const size_t heldReleaseSize = std::min(releaseSize, heldData.size());
+            decryptData(heldData.data(), heldReleaseSize);
+            heldData.erase(heldData.begin(), heldData.begin() + heldReleaseSize);
+            decryptData(payload, releaseSize - heldReleaseSize);
+            payload += releaseSize - heldReleaseSize;
+            payloadSize -= releaseSize - heldReleaseSize;
+        }
+        heldData.insert(heldData.end(), payload, payload + payloadSize);
+    };
+
+    VirgilByteArray data(internal::kDataBufferSize);
+    VirgilByteArray contentHeldData;
+    while (reader->hasData() && writer->isGood()) {
+        const size_t dataSize = reader->readInto(data.data(), data.size());
+        const size_t payloadOffset = filterAndSetupContentInfo(data.data(), dataSize, false, contentHeldData);
+        if (isReadyForDecryption()) {
+            consumeData(contentHeldData.data(), contentHeldData.size());
+            consumeData(data.data() + payloadOffset, dataSize - payloadOffset);
+        }
+    }
+
+    filterAndSetupContentInfo(data.data(), 0, true, contentHeldData);
+    consumeData(contentHeldData.data(), contentHeldData.size());
+
+    // Extract signature
+    VirgilByteArray signature;
+    if (hasSignatureTrailer) {
+        if (heldData.size() < kSignatureSizeLength) {
+            throw make_error(VirgilCryptoError::InvalidFormat, "Signature trailer is absent.");
+        }
+        size_t signatureSize = 0;
+        for (size_t i = heldData.size() - kSignatureSizeLength; i < heldData.size(); ++i) {
+            signatureSize = (signatureSize << 8) | heldData[i];
+        }
+        if (signatureSize > heldData.size() - kSignatureSizeLength) {
+            throw make_error(VirgilCryptoError::InvalidFormat, "Signature trailer is malformed.");
+        }
+        const size_t dataSize = heldData.size() - kSignatureSizeLength - signatureSize;
+        decryptData(heldData.data(), dataSize);
+        signature.assign(heldData.cbegin() + dataSize, heldData.cend() - kSignatureSizeLength);
+    } else {
+        signature = customParams().getData(str2bytes(kCustomParameterKey_Signature));
+    }
+
+    const VirgilByteArray decryptedTail = getSymmetricCipher().finish();
+    hash->update(decryptedTail);
+    VirgilDataSink::safeWrite(sink, decryptedTail);
+
+    // Verify
+    Impl verifier(impl_->getHashAlgorithm());
+    const VirgilByteArray unpackedSignature = verifier.unpackSignature(signature);
+    if (VirgilHash(verifier.getHashAlgorithm()).name() != hash->name()) {
+        return false;
+    }
+    return verifier.verifyHash(hash->finish(), unpackedSignature, signerPublicKey);
+}
@@ -36,12 +36,38 @@
 
 #include <virgil/crypto/VirgilStreamSigner.h>
 
+#include "VirgilDataIO.h"
+#include "VirgilPipeline.h"
+
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilDataSource;
+using virgil::crypto::VirgilDataReader;
 using virgil::crypto::VirgilStreamSigner;
 
 using virgil::crypto::foundation::VirgilHash;
 
+void VirgilStreamSigner::setPipelineDepth(size_t depth) {
+    pipelineDepth_ = depth;
+}
+
+size_t VirgilStreamSigner::getPipelineDepth() const {
+    return pipelineDepth_;
+}
+
+void VirgilStreamSigner::updateHash(VirgilHash& hash, VirgilDataSource& source) const {
+    auto reader = internal::as_data_reader(source);
+    if (pipelineDepth_ == 0 && reader != nullptr) {
+        VirgilByteArray data(internal::kDataBufferSize);
+        while (reader->hasData()) {
+            hash.update(data.data(), reader->readInto(data.data(), data.size()));
+        }
+    } else {
+        internal::pipeline_read(source, pipelineDepth_, [&hash](const VirgilByteArray& data) {
+            hash.update(data);
+        });
+    }
+}
+
 VirgilByteArray VirgilStreamSigner::sign(
         VirgilDataSource& source, const VirgilByteArray& privateKey,
         const VirgilByteArray& privateKeyPassword) {
@@ -49,9 +75,7 @@ VirgilByteArray VirgilStreamSigner::sign(
     // Calculate data digest
     VirgilHash hash(getHashAlgorithm());
     hash.start();
-    while (source.hasData()) {
-        hash.update(source.read());
-    }
+    updateHash(hash, source);
     const auto digest = hash.finish();
 
     // Sign digest
@@ -70,9 +94,7 @@ bool VirgilStreamSigner::verify(
     // Calculate data digest
     VirgilHash hash(getHashAlgorithm());
     hash.start();
-    while (source.hasData()) {
-        hash.update(source.read());
-    }
+    updateHash(hash, source);
     const auto digest = hash.finish();
 
     // Verify signature
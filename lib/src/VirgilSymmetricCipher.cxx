@@ -251,49 +251,64 @@ VirgilByteArray VirgilSymmetricCipher::crypt(const VirgilByteArray& input, const
 
 VirgilByteArray VirgilSymmetricCipher::update(const VirgilByteArray& input) {
     checkState();
+    VirgilByteArray result(input.size() + blockSize());
+    result.resize(update(input.data(), input.size(), result.data(), result.size()));
+    return result;
+}
+
+size_t VirgilSymmetricCipher::update(
+        const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize) {
+    checkState();
+    if (outputSize < inputSize + (isSupportPadding() ? blockSize() : 0)) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Output buffer is too small.");
+    }
     size_t writtenBytes = 0;
-    size_t bufLen = input.size() + this->blockSize();
-    VirgilByteArray result(bufLen);
 
     if (isDecryptionMode() && isAuthMode()) {
-        impl_->tagFilter.process(input);
-        if (impl_->tagFilter.hasData()) {
-            VirgilByteArray data = impl_->tagFilter.popData();
+        impl_->tagFilter.process(input, inputSize, [this, output, &writtenBytes](
+                const unsigned char* data, size_t dataSize) {
+            size_t updatedBytes = 0;
             system_crypto_handler(
-                    mbedtls_cipher_update(impl_->cipher_ctx.get(), data.data(), data.size(), result.data(),
-                            &writtenBytes),
+                    mbedtls_cipher_update(
+                            impl_->cipher_ctx.get(), data, dataSize, output + writtenBytes, &updatedBytes),
                     [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
             );
-        }
+            writtenBytes += updatedBytes;
+        });
     } else {
         system_crypto_handler(
-                mbedtls_cipher_update(impl_->cipher_ctx.get(), input.data(), input.size(), result.data(),
-                        &writtenBytes),
+                mbedtls_cipher_update(impl_->cipher_ctx.get(), input, inputSize, output, &writtenBytes),
                 [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
         );
     }
 
-    result.resize(writtenBytes);
-    return result;
+    return writtenBytes;
 }
 
 VirgilByteArray VirgilSymmetricCipher::finish() {
     checkState();
+    VirgilByteArray result(blockSize() + authTagLength());
+    result.resize(finish(result.data(), result.size()));
+    return result;
+}
+
+size_t VirgilSymmetricCipher::finish(unsigned char* output, size_t outputSize) {
+    checkState();
+    if (outputSize < (isSupportPadding() ? blockSize() : 0) + (isEncryptionMode() ? authTagLength() : 0)) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Output buffer is too small.");
+    }
     size_t writtenBytes = 0;
-    VirgilByteArray result(blockSize());
     system_crypto_handler(
-            mbedtls_cipher_finish(impl_->cipher_ctx.get(), result.data(), &writtenBytes),
+            mbedtls_cipher_finish(impl_->cipher_ctx.get(), output, &writtenBytes),
             [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
     );
-    result.resize(writtenBytes);
     if (isAuthMode()) {
         if (isEncryptionMode()) {
-            VirgilByteArray tag(authTagLength());
             system_crypto_handler(
-                    mbedtls_cipher_write_tag(impl_->cipher_ctx.get(), tag.data(), tag.size()),
+                    mbedtls_cipher_write_tag(impl_->cipher_ctx.get(), output + writtenBytes, authTagLength()),
                     [](int) { std::throw_with_nested(make_error(VirgilCryptoError::InvalidState)); }
             );
-            result.insert(result.end(), tag.begin(), tag.end());
+            writtenBytes += authTagLength();
         } else if (isDecryptionMode()) {
             VirgilByteArray tag = impl_->tagFilter.tag();
             system_crypto_handler(
@@ -302,7 +317,7 @@ VirgilByteArray VirgilSymmetricCipher::finish() {
             );
         }
     }
-    return result;
+    return writtenBytes;
 }
 
 void VirgilSymmetricCipher::checkState() const {
@@ -36,29 +36,35 @@
 
 #include "VirgilTagFilter.h"
 
+#include <virgil/crypto/VirgilCryptoError.h>
+
 using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
 using virgil::crypto::foundation::internal::VirgilTagFilter;
 
+constexpr size_t VirgilTagFilter::kTagLenMax;
 
-VirgilTagFilter::VirgilTagFilter() : tagLen_(0), data_(), tag_() {
+VirgilTagFilter::VirgilTagFilter() : tagLen_(0), data_(), tag_(), tagSize_(0) {
 }
 
 void VirgilTagFilter::reset(size_t tagLen) {
+    if (tagLen > kTagLenMax) {
+        throw make_error(VirgilCryptoError::InvalidArgument, "Tag length is too big.");
+    }
     tagLen_ = tagLen;
     data_.clear();
-    tag_.clear();
+    tagSize_ = 0;
 }
 
 void VirgilTagFilter::process(const VirgilByteArray& data) {
-    tag_.insert(tag_.end(), data.begin(), data.end());
+    process(data.data(), data.size());
+}
 
-    std::ptrdiff_t tagSurplusLen = tag_.size() - tagLen_;
-    if (tagSurplusLen > 0) {
-        auto tagSurplusBegin = tag_.begin();
-        auto tagSurplusEnd = tagSurplusBegin + tagSurplusLen;
-        data_.insert(data_.end(), tagSurplusBegin, tagSurplusEnd);
-        tag_.erase(tagSurplusBegin, tagSurplusEnd);
-    }
+void VirgilTagFilter::process(const unsigned char* data, size_t dataSize) {
+    process(data, dataSize, [this](const unsigned char* filteredData, size_t filteredDataSize) {
+        data_.insert(data_.end(), filteredData, filteredData + filteredDataSize);
+    });
 }
 
 bool VirgilTagFilter::hasData() const {
@@ -72,5 +78,5 @@ VirgilByteArray VirgilTagFilter::popData() {
 }
 
 VirgilByteArray VirgilTagFilter::tag() const {
-    return tag_;
+    return VirgilByteArray(tag_, tag_ + tagSize_);
 }
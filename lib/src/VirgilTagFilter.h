@@ -37,7 +37,9 @@
 #ifndef VIRGIL_CRYPTO_TAG_FILTER_H
 #define VIRGIL_CRYPTO_TAG_FILTER_H
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include <virgil/crypto/VirgilByteArray.h>
 
@@ -45,10 +47,19 @@ namespace virgil { namespace crypto { namespace foundation { namespace internal
 
 /**
  * @brief This class analize incoming data stream to filter Virgil TAG.
+ *
+ * Only trailing bytes that can be a part of the TAG are held back within fixed inline buffer,
+ *     all preceding bytes are passed through without intermediate copying.
+ *
  * @note Virgil TAG MUST be at the end of the data stream.
  */
 class VirgilTagFilter {
 public:
+    /**
+     * @brief Maximum supported length of the Virgil TAG.
+     */
+    static constexpr size_t kTagLenMax = 16;
+
     /**
      * @brief Base initialization.
      * @note Method reset() MUST be called anyway.
@@ -59,14 +70,33 @@ public:
      * @brief Get ready for data filtration.
      * @param tagLen - length of the expected Virgil TAG.
      * @note This method MUST be called before any data will be processed.
+     * @throw VirgilCryptoException with VirgilCryptoError::InvalidArgument, if tagLen exceeds kTagLenMax.
      */
     void reset(size_t tagLen);
 
+    /**
+     * @brief Filter given data, and pass data that precedes the TAG to the given consumer.
+     *
+     * Consumer is called at most twice with arguments (const unsigned char* data, size_t dataSize).
+     *     If previously held back bytes are passed, they are joined with the beginning of the given data,
+     *     so length of the first portion is multiple of the TAG length if enough data is given.
+     *     It allows to keep block alignment of the data passed to the cipher, when TAG length equals block size.
+     */
+    template<typename Consumer>
+    void process(const unsigned char* data, size_t dataSize, Consumer&& consumer);
+
     /**
      * @brief Filter given data.
+     * @note Filtered data is accumulated, and can be taken with method popData().
      */
     void process(const virgil::crypto::VirgilByteArray& data);
 
+    /**
+     * @brief Filter given data.
+     * @note Filtered data is accumulated, and can be taken with method popData().
+     */
+    void process(const unsigned char* data, size_t dataSize);
+
     /**
      * @brief Return if data exist after filtration.
      */
@@ -87,9 +117,45 @@ public:
 private:
     size_t tagLen_;
     virgil::crypto::VirgilByteArray data_;
-    virgil::crypto::VirgilByteArray tag_;
+    unsigned char tag_[kTagLenMax];
+    size_t tagSize_;
 };
 
+template<typename Consumer>
+void VirgilTagFilter::process(const unsigned char* data, size_t dataSize, Consumer&& consumer) {
+    if (tagLen_ == 0) {
+        if (dataSize > 0) {
+            consumer(data, dataSize);
+        }
+        return;
+    }
+
+    const size_t releaseSize = tagSize_ + dataSize > tagLen_ ? tagSize_ + dataSize - tagLen_ : 0;
+    const size_t tagReleaseSize = std::min(releaseSize, tagSize_);
+    size_t dataReleaseSize = releaseSize - tagReleaseSize;
+
+    if (tagReleaseSize > 0) {
+        // Join released bytes with the beginning of the data to keep block alignment.
+        const size_t joinSize = std::min(dataReleaseSize, (tagLen_ - tagReleaseSize % tagLen_) % tagLen_);
+        unsigned char joined[2 * kTagLenMax];
+        std::memcpy(joined, tag_, tagReleaseSize);
+        std::memcpy(joined + tagReleaseSize, data, joinSize);
+        std::memmove(tag_, tag_ + tagReleaseSize, tagSize_ - tagReleaseSize);
+        tagSize_ -= tagReleaseSize;
+        data += joinSize;
+        dataSize -= joinSize;
+        dataReleaseSize -= joinSize;
+        consumer(static_cast<const unsigned char*>(joined), tagReleaseSize + joinSize);
+    }
+
+    if (dataReleaseSize > 0) {
+        consumer(data, dataReleaseSize);
+    }
+
+    std::memcpy(tag_ + tagSize_, data + dataReleaseSize, dataSize - dataReleaseSize);
+    tagSize_ += dataSize - dataReleaseSize;
+}
+
 }}}}
 
 #endif /* VIRGIL_CRYPTO_TAG_FILTER_H */
@@ -229,7 +229,7 @@ public:
     }
 };
 
-inline VirgilByteArray randomize(mbedtls_context<mbedtls_ctr_drbg_context>& ctr_drbg_ctx, size_t bytesNum) {
+inline VirgilByteArray randomize(mbedtls_ctr_drbg_context* ctr_drbg_ctx, size_t bytesNum) {
     std::array<unsigned char, MBEDTLS_CTR_DRBG_MAX_REQUEST> buf;
 
     VirgilByteArray randomBytes;
@@ -237,18 +237,18 @@ inline VirgilByteArray randomize(mbedtls_context<mbedtls_ctr_drbg_context>& ctr_
     while (randomBytes.size() < bytesNum) {
         const size_t randomChunkSize = std::min(bytesNum, (size_t) MBEDTLS_CTR_DRBG_MAX_REQUEST);
         system_crypto_handler(
-                mbedtls_ctr_drbg_random(ctr_drbg_ctx.get(), buf.data(), randomChunkSize));
+                mbedtls_ctr_drbg_random(ctr_drbg_ctx, buf.data(), randomChunkSize));
         randomBytes.insert(randomBytes.end(), buf.begin(), buf.begin() + randomChunkSize);
     }
     return randomBytes;
 };
 
-inline size_t randomize(mbedtls_context<mbedtls_ctr_drbg_context>& ctr_drbg_ctx) {
+inline size_t randomize(mbedtls_ctr_drbg_context* ctr_drbg_ctx) {
     VirgilByteArray randomBytes = randomize(ctr_drbg_ctx, sizeof(size_t));
     return *((size_t*) &randomBytes[0]);
 }
 
-inline size_t randomize(mbedtls_context<mbedtls_ctr_drbg_context>& ctr_drbg_ctx, size_t min, size_t max) {
+inline size_t randomize(mbedtls_ctr_drbg_context* ctr_drbg_ctx, size_t min, size_t max) {
     if (min >= max) {
         throw make_error(VirgilCryptoError::InvalidArgument, "MIN value is greater or equal to MAX.");
     }
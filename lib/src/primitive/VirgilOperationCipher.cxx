@@ -39,26 +39,30 @@
 
 #include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
 
+#include "VirgilSymmetricCrypt.h"
+
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::primitive::VirgilOperationCipher;
 using virgil::crypto::foundation::VirgilSymmetricCipher;
+using virgil::crypto::foundation::internal::symmetric_crypt;
 
 namespace {
 
 class VirgilSymmetricCipherWrapper {
 public:
 
-    VirgilSymmetricCipherWrapper()
-            : cipherAlgorithm_(VirgilSymmetricCipher::Algorithm::AES_256_GCM) {}
+    VirgilSymmetricCipherWrapper() : cipherAlgorithm_(VirgilSymmetricCipher::Algorithm::AES_256_GCM) {
+        VirgilSymmetricCipher cipher(cipherAlgorithm_);
+        keySize_ = cipher.keyLength();
+        nonceSize_ = cipher.ivSize();
+    }
 
     size_t getKeySize() const {
-        VirgilSymmetricCipher cipher(cipherAlgorithm_);
-        return cipher.keyLength();
+        return keySize_;
     }
 
     size_t getNonceSize() const {
-        VirgilSymmetricCipher cipher(cipherAlgorithm_);
-        return cipher.ivSize();
+        return nonceSize_;
     }
 
     VirgilByteArray encrypt(
@@ -67,14 +71,7 @@ public:
 
         VirgilSymmetricCipher cipher(cipherAlgorithm_);
         cipher.setEncryptionKey(key);
-        cipher.setIV(nonce);
-        cipher.setAuthData(authData);
-        cipher.reset();
-
-        auto cipherText = VirgilByteArray();
-        virgil::crypto::bytes_append(cipherText, cipher.update(plainText));
-        virgil::crypto::bytes_append(cipherText, cipher.finish());
-        return cipherText;
+        return symmetric_crypt(cipher, plainText, nonce, authData);
     }
 
     VirgilByteArray decrypt(
@@ -83,18 +80,13 @@ public:
 
         VirgilSymmetricCipher cipher(cipherAlgorithm_);
         cipher.setDecryptionKey(key);
-        cipher.setIV(nonce);
-        cipher.setAuthData(authData);
-        cipher.reset();
-
-        auto plainText = VirgilByteArray();
-        virgil::crypto::bytes_append(plainText, cipher.update(cipherText));
-        virgil::crypto::bytes_append(plainText, cipher.finish());
-        return plainText;
+        return symmetric_crypt(cipher, cipherText, nonce, authData);
     }
 
 private:
     VirgilSymmetricCipher::Algorithm cipherAlgorithm_;
+    size_t keySize_;
+    size_t nonceSize_;
 };
 
 }
@@ -40,11 +40,10 @@
 
 #include <virgil/crypto/pythia/VirgilPythiaError.h>
 
-#include "mbedtls_context.h"
+#include "VirgilRandomPool.h"
 #include "utils.h"
 
 #include <mbedtls/ctr_drbg.h>
-#include <mbedtls/entropy.h>
 
 #include <iostream>
 #include <string>
@@ -57,7 +56,7 @@
 #include <tinyformat/tinyformat.h>
 
 using virgil::crypto::make_error;
-using virgil::crypto::foundation::internal::mbedtls_context;
+using virgil::crypto::foundation::internal::VirgilRandomPool;
 using virgil::crypto::pythia::pythia_handler;
 using virgil::crypto::pythia::VirgilPythiaContext;
 
@@ -68,8 +67,7 @@ using virgil::crypto::pythia::VirgilPythiaContext;
 #endif
 
 
-static VIRGIL_THREAD_LOCAL mbedtls_context<mbedtls_entropy_context> g_entropy_ctx;
-static VIRGIL_THREAD_LOCAL mbedtls_context<mbedtls_ctr_drbg_context> g_rng_ctx;
+static VIRGIL_THREAD_LOCAL VirgilRandomPool::Lease g_rng_ctx;
 static size_t g_instances;
 static std::mutex g_instances_mutex;
 
@@ -82,8 +80,7 @@ namespace internal {
 class PythiaContext {
 public:
     PythiaContext() {
-        constexpr const char pers[] = "VirgilPythiaContext";
-        g_rng_ctx.setup(mbedtls_entropy_func, g_entropy_ctx.get(), pers);
+        g_rng_ctx = VirgilRandomPool::acquire();
 
         std::lock_guard<std::mutex> lock_guard(g_instances_mutex);
         if (g_instances++ > 0) {
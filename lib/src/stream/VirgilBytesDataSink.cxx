@@ -55,6 +55,10 @@ void VirgilBytesDataSink::write(const VirgilByteArray& data) {
     out_.insert(out_.end(), data.begin(), data.end());
 }
 
+void VirgilBytesDataSink::write(const unsigned char* data, size_t dataSize) {
+    out_.insert(out_.end(), data, data + dataSize);
+}
+
 void VirgilBytesDataSink::reset() {
     out_.clear();
 }
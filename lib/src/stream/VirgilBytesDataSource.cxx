@@ -40,6 +40,7 @@
 #include <virgil/crypto/stream/VirgilBytesDataSource.h>
 
 #include <algorithm>
+#include <cstring>
 
 using virgil::crypto::stream::VirgilBytesDataSource;
 using virgil::crypto::VirgilByteArray;
@@ -62,6 +63,19 @@ void VirgilBytesDataSource::reset() {
     leftBytes_ = in_.size();
 }
 
+size_t VirgilBytesDataSource::readInto(unsigned char* buffer, size_t bufferSize) {
+    const size_t readSize = std::min(bufferSize, leftBytes_);
+    if (readSize > 0) {
+        std::memcpy(buffer, in_.data() + in_.size() - leftBytes_, readSize);
+    }
+    leftBytes_ -= readSize;
+    return readSize;
+}
+
+void VirgilBytesDataSource::seek(size_t position) {
+    leftBytes_ = in_.size() - std::min(position, in_.size());
+}
+
 VirgilByteArray VirgilBytesDataSource::read() {
     size_t actualChunkSize = std::min(chunkSize_, leftBytes_);
     VirgilByteArray::const_iterator start = in_.begin() + in_.size() - leftBytes_;
@@ -0,0 +1,101 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include <virgil/crypto/stream/VirgilMappedFileDataSink.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <virgil/crypto/VirgilCryptoError.h>
+
+#include "VirgilMappedFile.h"
+#include "utils.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
+using virgil::crypto::internal::VirgilMappedFile;
+using virgil::crypto::stream::VirgilMappedFileDataSink;
+
+class VirgilMappedFileDataSink::Impl {
+public:
+    explicit Impl(const std::string& path) : file(path, true), written(0) {}
+
+    VirgilMappedFile file;
+    size_t written;
+};
+
+VirgilMappedFileDataSink::VirgilMappedFileDataSink(const std::string& path)
+        : impl_(std::make_unique<Impl>(path)) {
+}
+
+VirgilMappedFileDataSink::~VirgilMappedFileDataSink() noexcept {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+bool VirgilMappedFileDataSink::isGood() {
+    return impl_->file.isOpened();
+}
+
+void VirgilMappedFileDataSink::write(const VirgilByteArray& data) {
+    write(data.data(), data.size());
+}
+
+void VirgilMappedFileDataSink::write(const unsigned char* data, size_t dataSize) {
+    if (!impl_->file.isOpened()) {
+        throw make_error(VirgilCryptoError::InvalidState, "Data sink is closed.");
+    }
+    size_t dataOffset = 0;
+    while (dataOffset < dataSize) {
+        size_t available = 0;
+        unsigned char* window = impl_->file.map(impl_->written, available);
+        const size_t writeSize = std::min(available, dataSize - dataOffset);
+        std::memcpy(window, data + dataOffset, writeSize);
+        dataOffset += writeSize;
+        impl_->written += writeSize;
+    }
+}
+
+void VirgilMappedFileDataSink::close() {
+    impl_->file.close(impl_->written);
+}
+
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
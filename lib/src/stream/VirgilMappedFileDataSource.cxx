@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include <virgil/crypto/stream/VirgilMappedFileDataSource.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "VirgilMappedFile.h"
+#include "utils.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::internal::VirgilMappedFile;
+using virgil::crypto::stream::VirgilMappedFileDataSource;
+
+static const size_t kChunkSizeMin = 32;
+
+constexpr size_t VirgilMappedFileDataSource::kChunkSizeDefault;
+
+class VirgilMappedFileDataSource::Impl {
+public:
+    Impl(const std::string& path, size_t chunkSize)
+            : file(path, false), chunkSize(std::max(chunkSize, kChunkSizeMin)), position(0) {}
+
+    VirgilMappedFile file;
+    const size_t chunkSize;
+    size_t position;
+};
+
+VirgilMappedFileDataSource::VirgilMappedFileDataSource(const std::string& path, size_t chunkSize)
+        : impl_(std::make_unique<Impl>(path, chunkSize)) {
+}
+
+VirgilMappedFileDataSource::~VirgilMappedFileDataSource() noexcept {
+}
+
+bool VirgilMappedFileDataSource::hasData() {
+    return impl_->position < impl_->file.size();
+}
+
+VirgilByteArray VirgilMappedFileDataSource::read() {
+    size_t available = 0;
+    const unsigned char* data = impl_->file.map(impl_->position, available);
+    const size_t readSize = std::min(impl_->chunkSize, available);
+    impl_->position += readSize;
+    return VirgilByteArray(data, data + readSize);
+}
+
+size_t VirgilMappedFileDataSource::readInto(unsigned char* buffer, size_t bufferSize) {
+    size_t readSize = 0;
+    while (readSize < bufferSize) {
+        size_t available = 0;
+        const unsigned char* data = impl_->file.map(impl_->position, available);
+        const size_t portionSize = std::min(bufferSize - readSize, available);
+        if (portionSize == 0) {
+            break;
+        }
+        std::memcpy(buffer + readSize, data, portionSize);
+        readSize += portionSize;
+        impl_->position += portionSize;
+    }
+    return readSize;
+}
+
+void VirgilMappedFileDataSource::seek(size_t position) {
+    impl_->position = position;
+}
+
+size_t VirgilMappedFileDataSource::size() const {
+    return impl_->file.size();
+}
+
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
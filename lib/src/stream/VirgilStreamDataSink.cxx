@@ -54,6 +54,10 @@ void VirgilStreamDataSink::write(const VirgilByteArray& data) {
     out_.write(reinterpret_cast<const std::ostream::char_type*>(data.data()), data.size());
 }
 
+void VirgilStreamDataSink::write(const unsigned char* data, size_t dataSize) {
+    out_.write(reinterpret_cast<const std::ostream::char_type*>(data), dataSize);
+}
+
 VirgilStreamDataSink::~VirgilStreamDataSink() noexcept {
 }
 
@@ -38,11 +38,14 @@
 #if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
 
 #include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilCryptoError.h>
 #include <virgil/crypto/stream/VirgilStreamDataSource.h>
 
 #include <algorithm>
 
 using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoError;
+using virgil::crypto::make_error;
 using virgil::crypto::stream::VirgilStreamDataSource;
 
 static const size_t kChunkSizeMin = 32;
@@ -68,4 +71,19 @@ VirgilByteArray VirgilStreamDataSource::read() {
     return result;
 }
 
+size_t VirgilStreamDataSource::readInto(unsigned char* buffer, size_t bufferSize) {
+    in_.read(reinterpret_cast<std::istream::char_type*>(buffer), bufferSize);
+    return static_cast<size_t>(in_.gcount());
+}
+
+void VirgilStreamDataSource::seek(size_t position) {
+    in_.clear();
+    in_.seekg(static_cast<std::istream::off_type>(position), std::ios_base::beg);
+    if (in_.fail()) {
+        throw make_error(VirgilCryptoError::InvalidState, "Underlying stream does not support seeking.");
+    }
+    // Mark stream as exhausted if position is beyond the end.
+    in_.peek();
+}
+
 #endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
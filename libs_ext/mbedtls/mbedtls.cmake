@@ -96,6 +96,10 @@ ExternalProject_Add (${PROJECT_NAME}
     UPDATE_COMMAND ${CMAKE_COMMAND} -E copy_directory
             ${CMAKE_CURRENT_BINARY_DIR}/configs
             ${CMAKE_CURRENT_BINARY_DIR}/src/${PROJECT_NAME}/include/mbedtls
+    PATCH_COMMAND ${CMAKE_COMMAND}
+            -DMBEDTLS_SOURCE_DIR=<SOURCE_DIR>
+            -DPATCH_DIR=${CMAKE_CURRENT_SOURCE_DIR}/patches
+            -P ${CMAKE_CURRENT_SOURCE_DIR}/patches/sha256_process_accel.cmake
 )
 
 add_custom_target ("${PROJECT_NAME}-build" ALL COMMENT "Build package ${PROJECT_NAME}")
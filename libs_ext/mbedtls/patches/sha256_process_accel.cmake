@@ -0,0 +1,76 @@
+#
+# Copyright (C) 2015-2018 Virgil Security Inc.
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     (1) Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#
+#     (2) Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#
+#     (3) Neither the name of the copyright holder nor the names of its
+#     contributors may be used to endorse or promote products derived from
+#     this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+# IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+# INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+# STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+# IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+# Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+#
+
+#
+# Patch MbedTLS 'sha256.c' to use hardware accelerated SHA-256 compression function when it is available.
+#
+# Portable mbedtls_sha256_process() is renamed to the virgil_sha256_process_portable(),
+# and 'sha256_process_accel.h' that defines new dispatching mbedtls_sha256_process() is appended.
+#
+# Parameters:
+#     MBEDTLS_SOURCE_DIR - path to the MbedTLS source tree.
+#     PATCH_DIR - path to the directory that contains 'sha256_process_accel.h'.
+#
+
+cmake_minimum_required (VERSION 3.10 FATAL_ERROR)
+
+set (sha256_source "${MBEDTLS_SOURCE_DIR}/library/sha256.c")
+set (sha256_patch_name "sha256_process_accel.h")
+
+if (NOT EXISTS "${sha256_source}")
+    message (FATAL_ERROR "File to be patched is not found: ${sha256_source}")
+endif ()
+
+file (READ "${sha256_source}" sha256_content)
+
+string (FIND "${sha256_content}" "${sha256_patch_name}" sha256_patched)
+if (NOT sha256_patched EQUAL -1)
+    message (STATUS "File is already patched: ${sha256_source}")
+    return ()
+endif ()
+
+string (REGEX REPLACE
+    "void[ \t]+mbedtls_sha256_process[ \t]*\\("
+    "static void virgil_sha256_process_portable("
+    sha256_patched_content "${sha256_content}"
+)
+
+if (sha256_patched_content STREQUAL sha256_content)
+    message (FATAL_ERROR "Definition of the mbedtls_sha256_process() is not found in the: ${sha256_source}")
+endif ()
+
+file (COPY "${PATCH_DIR}/${sha256_patch_name}" DESTINATION "${MBEDTLS_SOURCE_DIR}/library")
+file (WRITE "${sha256_source}" "${sha256_patched_content}\n#include \"${sha256_patch_name}\"\n")
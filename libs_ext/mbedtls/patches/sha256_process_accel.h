@@ -0,0 +1,266 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file sha256_process_accel.h
+ * @brief Hardware accelerated SHA-256 compression function for the MbedTLS library.
+ *
+ * This file is appended to the MbedTLS 'sha256.c' by the 'sha256_process_accel.cmake' patch script.
+ *     Original portable compression function is renamed to the virgil_sha256_process_portable(),
+ *     and mbedtls_sha256_process() defined here dispatches to the fastest implementation available at runtime:
+ *         - x86 / x86_64: SHA-NI (SHA extensions), detected with CPUID;
+ *         - AArch64: ARMv8 Cryptography Extensions, when toolchain targets them;
+ *         - otherwise: original portable implementation.
+ *
+ * All implementations produce identical results, so only speed is affected.
+ */
+
+#if defined(MBEDTLS_SHA256_C) && !defined(MBEDTLS_SHA256_PROCESS_ALT)
+
+#if defined(MBEDTLS_HAVE_ASM) && \
+        (defined(__x86_64__) || defined(__amd64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#if defined(__clang__)
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_ia32_sha256rnds2)
+#define VIRGIL_SHA256_SHANI
+#endif
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 5
+#define VIRGIL_SHA256_SHANI
+#elif defined(_MSC_VER) && _MSC_VER >= 1900
+#define VIRGIL_SHA256_SHANI
+#endif
+#endif
+
+#if defined(MBEDTLS_HAVE_ASM) && defined(__aarch64__) && \
+        (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define VIRGIL_SHA256_ARMV8
+#endif
+
+#if defined(VIRGIL_SHA256_SHANI) || defined(VIRGIL_SHA256_ARMV8)
+static const uint32_t virgil_sha256_k[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+#endif
+
+#if defined(VIRGIL_SHA256_SHANI)
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define VIRGIL_SHA256_SHANI_TARGET
+#else
+#include <cpuid.h>
+#define VIRGIL_SHA256_SHANI_TARGET __attribute__((target("sha,sse4.1")))
+#endif
+
+/*
+ * Return non-zero if CPU supports SHA extensions and SSE4.1.
+ */
+static int virgil_sha256_has_shani( void )
+{
+    static int done = 0;
+    static int supported = 0;
+
+    if( ! done )
+    {
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuid( regs, 0 );
+        if( regs[0] >= 7 )
+        {
+            int sse41;
+            __cpuid( regs, 1 );
+            sse41 = ( regs[2] >> 19 ) & 1;
+            __cpuidex( regs, 7, 0 );
+            supported = sse41 && ( ( regs[1] >> 29 ) & 1 );
+        }
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if( __get_cpuid_max( 0, NULL ) >= 7 )
+        {
+            int sse41;
+            __cpuid( 1, eax, ebx, ecx, edx );
+            sse41 = ( ecx >> 19 ) & 1;
+            __cpuid_count( 7, 0, eax, ebx, ecx, edx );
+            supported = sse41 && ( ( ebx >> 29 ) & 1 );
+        }
+#endif
+        done = 1;
+    }
+
+    return( supported );
+}
+
+/*
+ * SHA-256 compression function with SHA-NI.
+ * Message schedule is kept in the 4 registers: each holds 4 words, words are computed 4 at a time.
+ */
+VIRGIL_SHA256_SHANI_TARGET
+static void virgil_sha256_process_shani( uint32_t state[8], const unsigned char data[64] )
+{
+    __m128i state0, state1, abef_save, cdgh_save, msg, tmp, mask;
+    __m128i w[4];
+    int i;
+
+    mask = _mm_set_epi8( 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3 );
+
+    /* Convert state to the ABEF / CDGH layout that is expected by the SHA-NI instructions */
+    tmp = _mm_loadu_si128( (const __m128i*) &state[0] );
+    state1 = _mm_loadu_si128( (const __m128i*) &state[4] );
+    tmp = _mm_shuffle_epi32( tmp, 0xB1 );
+    state1 = _mm_shuffle_epi32( state1, 0x1B );
+    state0 = _mm_alignr_epi8( tmp, state1, 8 );
+    state1 = _mm_blend_epi16( state1, tmp, 0xF0 );
+
+    abef_save = state0;
+    cdgh_save = state1;
+
+    for( i = 0; i < 16; i++ )
+    {
+        if( i < 4 )
+        {
+            w[i] = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i*) ( data + 16 * i ) ), mask );
+        }
+        else
+        {
+            /* W[t] = s1(W[t-2]) + W[t-7] + s0(W[t-15]) + W[t-16] */
+            tmp = _mm_sha256msg1_epu32( w[i & 3], w[( i + 1 ) & 3] );
+            tmp = _mm_add_epi32( tmp, _mm_alignr_epi8( w[( i + 3 ) & 3], w[( i + 2 ) & 3], 4 ) );
+            w[i & 3] = _mm_sha256msg2_epu32( tmp, w[( i + 3 ) & 3] );
+        }
+
+        msg = _mm_add_epi32( w[i & 3], _mm_loadu_si128( (const __m128i*) &virgil_sha256_k[4 * i] ) );
+        state1 = _mm_sha256rnds2_epu32( state1, state0, msg );
+        msg = _mm_shuffle_epi32( msg, 0x0E );
+        state0 = _mm_sha256rnds2_epu32( state0, state1, msg );
+    }
+
+    state0 = _mm_add_epi32( state0, abef_save );
+    state1 = _mm_add_epi32( state1, cdgh_save );
+
+    /* Convert state back to the ABCD / EFGH layout */
+    tmp = _mm_shuffle_epi32( state0, 0x1B );
+    state1 = _mm_shuffle_epi32( state1, 0xB1 );
+    state0 = _mm_blend_epi16( tmp, state1, 0xF0 );
+    state1 = _mm_alignr_epi8( state1, tmp, 8 );
+
+    _mm_storeu_si128( (__m128i*) &state[0], state0 );
+    _mm_storeu_si128( (__m128i*) &state[4], state1 );
+}
+
+#endif /* VIRGIL_SHA256_SHANI */
+
+#if defined(VIRGIL_SHA256_ARMV8)
+
+#include <arm_neon.h>
+
+/*
+ * Toolchain targets ARMv8 Cryptography Extensions, so every CPU that runs this code supports them.
+ */
+static int virgil_sha256_has_armv8( void )
+{
+    return( 1 );
+}
+
+/*
+ * SHA-256 compression function with ARMv8 Cryptography Extensions.
+ */
+static void virgil_sha256_process_armv8( uint32_t state[8], const unsigned char data[64] )
+{
+    uint32x4_t state0, state1, abcd_save, efgh_save, msg, tmp;
+    uint32x4_t w[4];
+    int i;
+
+    state0 = vld1q_u32( &state[0] );
+    state1 = vld1q_u32( &state[4] );
+
+    abcd_save = state0;
+    efgh_save = state1;
+
+    for( i = 0; i < 16; i++ )
+    {
+        if( i < 4 )
+        {
+            w[i] = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 16 * i ) ) );
+        }
+        else
+        {
+            /* W[t] = s1(W[t-2]) + W[t-7] + s0(W[t-15]) + W[t-16] */
+            w[i & 3] = vsha256su1q_u32(
+                    vsha256su0q_u32( w[i & 3], w[( i + 1 ) & 3] ), w[( i + 2 ) & 3], w[( i + 3 ) & 3] );
+        }
+
+        msg = vaddq_u32( w[i & 3], vld1q_u32( &virgil_sha256_k[4 * i] ) );
+        tmp = state0;
+        state0 = vsha256hq_u32( state0, state1, msg );
+        state1 = vsha256h2q_u32( state1, tmp, msg );
+    }
+
+    vst1q_u32( &state[0], vaddq_u32( state0, abcd_save ) );
+    vst1q_u32( &state[4], vaddq_u32( state1, efgh_save ) );
+}
+
+#endif /* VIRGIL_SHA256_ARMV8 */
+
+void mbedtls_sha256_process( mbedtls_sha256_context *ctx, const unsigned char data[64] )
+{
+#if defined(VIRGIL_SHA256_SHANI)
+    if( virgil_sha256_has_shani() )
+    {
+        virgil_sha256_process_shani( ctx->state, data );
+        return;
+    }
+#endif
+#if defined(VIRGIL_SHA256_ARMV8)
+    if( virgil_sha256_has_armv8() )
+    {
+        virgil_sha256_process_armv8( ctx->state, data );
+        return;
+    }
+#endif
+    virgil_sha256_process_portable( ctx, data );
+}
+
+#endif /* MBEDTLS_SHA256_C && !MBEDTLS_SHA256_PROCESS_ALT */
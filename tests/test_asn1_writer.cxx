@@ -178,6 +178,16 @@ TEST_CASE("ASN.1 write: use small buffer", "[asn1-writer]") {
         );
     }
 
+    SECTION("with unordered set") {
+        std::vector<VirgilByteArray> set;
+        for (const auto& item : { "0401ff", "04020001", "040100", "0400", "04010100" }) {
+            set.push_back(VirgilByteArrayUtils::hexToBytes(item));
+        }
+        asn1Writer.writeSet(set);
+        VirgilByteArray asn1 = asn1Writer.finish();
+        REQUIRE(VirgilByteArrayUtils::bytesToHex(asn1) == "3110" "0400" "040100" "04010100" "0401ff" "04020001");
+    }
+
     SECTION("with max set") {
         VirgilByteArray utf8StringHead = VirgilByteArrayUtils::hexToBytes("0c82fffb");
         VirgilByteArray utf8StringBody = VirgilByteArray(kAsn1LengthMax - utf8StringHead.size(), 0x41);
@@ -46,6 +46,11 @@
 #include <virgil/crypto/VirgilByteArrayUtils.h>
 #include <virgil/crypto/VirgilCipher.h>
 #include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilRecipientSet.h>
+#include <virgil/crypto/foundation/VirgilPBE.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+#include <virgil/crypto/foundation/cms/VirgilCMSContentInfo.h>
+#include <virgil/crypto/foundation/cms/VirgilCMSEnvelopedData.h>
 
 using virgil::crypto::str2bytes;
 using virgil::crypto::bytes2hex;
@@ -53,7 +58,15 @@ using virgil::crypto::bytes2str;
 using virgil::crypto::VirgilByteArray;
 using virgil::crypto::VirgilCipher;
 using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilRecipientSet;
 using virgil::crypto::VirgilByteArrayUtils;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
+using virgil::crypto::foundation::VirgilPBE;
+using virgil::crypto::foundation::VirgilRandom;
+using virgil::crypto::foundation::cms::VirgilCMSContent;
+using virgil::crypto::foundation::cms::VirgilCMSContentInfo;
+using virgil::crypto::foundation::cms::VirgilCMSEnvelopedData;
+using virgil::crypto::foundation::cms::VirgilCMSPasswordRecipient;
 
 
 static void test_encrypt_decrypt(const VirgilKeyPair& keyPair, const VirgilByteArray& keyPassword) {
@@ -249,6 +262,29 @@ TEST_CASE("VirgilCipher: encrypt and decrypt with password", "[cipher]") {
         );
         REQUIRE(testData == decryptedData);
     }
+
+    SECTION("given as pointer and length") {
+        VirgilByteArray encryptedData = cipher.encrypt(testData.data(), testData.size(), true);
+        VirgilByteArray decryptedData;
+        REQUIRE_THROWS(
+                decryptedData = cipher.decryptWithPassword(encryptedData.data(), encryptedData.size(), wrongPassword)
+        );
+        REQUIRE_NOTHROW(
+                decryptedData = cipher.decryptWithPassword(encryptedData.data(), encryptedData.size(), password)
+        );
+        REQUIRE(testData == decryptedData);
+        REQUIRE(cipher.decryptWithPassword(encryptedData, password) == testData);
+    }
+
+    SECTION("and separated content info given as pointer and length") {
+        VirgilByteArray encryptedData = cipher.encrypt(testData.data(), testData.size(), false);
+        cipher.setContentInfo(cipher.getContentInfo());
+        VirgilByteArray decryptedData;
+        REQUIRE_NOTHROW(
+                decryptedData = cipher.decryptWithPassword(encryptedData.data(), encryptedData.size(), password)
+        );
+        REQUIRE(testData == decryptedData);
+    }
 }
 
 TEST_CASE("VirgilCipher: check recipient existence", "[cipher]") {
@@ -299,3 +335,314 @@ TEST_CASE("VirgilCipher: add 512 recipients", "[cipher]") {
     REQUIRE_NOTHROW(decryptedData = cipher.decryptWithKey(encryptedData, lastRecipientId, commonKeyPair.privateKey()));
     REQUIRE(testData == decryptedData);
 }
+
+TEST_CASE("VirgilCipher: add 512 recipients and encrypt within several threads", "[cipher]") {
+    VirgilCipher cipher;
+    VirgilKeyPair commonKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilByteArray testData =
+            VirgilByteArrayUtils::stringToBytes("this string will be encrypted for a lot of recipients");
+
+    REQUIRE(cipher.getRecipientEncryptionThreads() == 1);
+    REQUIRE_THROWS(cipher.setRecipientEncryptionThreads(0));
+    REQUIRE_NOTHROW(cipher.setRecipientEncryptionThreads(4));
+    REQUIRE(cipher.getRecipientEncryptionThreads() == 4);
+
+    for (auto i = 0; i < 512; ++i) {
+        std::string recipientId = "recipient-" + std::to_string(i);
+        cipher.addKeyRecipient(VirgilByteArrayUtils::stringToBytes(recipientId), commonKeyPair.publicKey());
+    }
+
+    VirgilByteArray encryptedData;
+    REQUIRE_NOTHROW(encryptedData = cipher.encrypt(testData, true));
+
+    for (const auto& recipientId : { "recipient-0", "recipient-255", "recipient-511" }) {
+        VirgilCipher decipher;
+        VirgilByteArray decryptedData;
+        REQUIRE_NOTHROW(decryptedData = decipher.decryptWithKey(
+                encryptedData, VirgilByteArrayUtils::stringToBytes(recipientId), commonKeyPair.privateKey()));
+        REQUIRE(testData == decryptedData);
+    }
+}
+
+TEST_CASE("VirgilCipher: encrypt and decrypt to the given buffer", "[cipher]") {
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilByteArray password = str2bytes("password");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+
+    VirgilCipher cipher;
+    cipher.addKeyRecipient(recipientId, keyPair.publicKey());
+    cipher.addPasswordRecipient(password);
+
+    for (bool embedContentInfo : { true, false }) {
+        const size_t encryptedSize = cipher.encryptedSize(testData.size(), embedContentInfo);
+        const VirgilByteArray contentInfo = cipher.getContentInfo();
+
+        VirgilByteArray encryptedData(encryptedSize);
+        REQUIRE_THROWS(
+                cipher.encryptInto(testData.data(), testData.size(), encryptedData.data(), encryptedSize - 1,
+                        embedContentInfo)
+        );
+
+        REQUIRE(cipher.encryptedSize(testData.size(), embedContentInfo) == encryptedSize);
+        REQUIRE(cipher.getContentInfo() == contentInfo);
+        REQUIRE(cipher.encryptInto(testData.data(), testData.size(), encryptedData.data(), encryptedData.size(),
+                embedContentInfo) == encryptedSize);
+
+        if (!embedContentInfo) {
+            cipher.setContentInfo(cipher.getContentInfo());
+        }
+
+        VirgilByteArray decryptedData(encryptedSize);
+        size_t decryptedSize = 0;
+        REQUIRE_NOTHROW(
+                decryptedSize = cipher.decryptInto(encryptedData.data(), encryptedData.size(),
+                        decryptedData.data(), decryptedData.size(), recipientId, keyPair.privateKey())
+        );
+        decryptedData.resize(decryptedSize);
+        REQUIRE(decryptedData == testData);
+
+        if (!embedContentInfo) {
+            cipher.setContentInfo(cipher.getContentInfo());
+        }
+
+        decryptedData.resize(encryptedSize);
+        REQUIRE_NOTHROW(
+                decryptedSize = cipher.decryptInto(encryptedData.data(), encryptedData.size(),
+                        decryptedData.data(), decryptedData.size(), password)
+        );
+        decryptedData.resize(decryptedSize);
+        REQUIRE(decryptedData == testData);
+    }
+}
+
+TEST_CASE("VirgilCipher: change recipients after encrypted size query", "[cipher]") {
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+    VirgilByteArray bobId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair bobKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilByteArray aliceId = str2bytes("968dc52d-2045-4abe-ab51-0b04737cac76");
+    VirgilKeyPair aliceKeyPair = VirgilKeyPair::generateRecommended();
+
+    VirgilCipher cipher;
+    cipher.addKeyRecipient(bobId, bobKeyPair.publicKey());
+    const size_t bobOnlySize = cipher.encryptedSize(testData.size());
+
+    SECTION("recipient is added") {
+        cipher.addKeyRecipient(aliceId, aliceKeyPair.publicKey());
+
+        VirgilByteArray encryptedData(2 * bobOnlySize);
+        encryptedData.resize(
+                cipher.encryptInto(testData.data(), testData.size(), encryptedData.data(), encryptedData.size()));
+        REQUIRE(encryptedData.size() > bobOnlySize);
+
+        REQUIRE(VirgilCipher().decryptWithKey(encryptedData, aliceId, aliceKeyPair.privateKey()) == testData);
+        REQUIRE(VirgilCipher().decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()) == testData);
+    }
+    SECTION("recipient is added and size is queried again") {
+        cipher.addKeyRecipient(aliceId, aliceKeyPair.publicKey());
+
+        VirgilByteArray encryptedData(cipher.encryptedSize(testData.size()));
+        REQUIRE(encryptedData.size() > bobOnlySize);
+        REQUIRE(cipher.encryptInto(testData.data(), testData.size(), encryptedData.data(), encryptedData.size()) ==
+                encryptedData.size());
+
+        REQUIRE(VirgilCipher().decryptWithKey(encryptedData, aliceId, aliceKeyPair.privateKey()) == testData);
+    }
+    SECTION("recipient is removed") {
+        cipher.removeKeyRecipient(bobId);
+        cipher.addKeyRecipient(aliceId, aliceKeyPair.publicKey());
+
+        VirgilByteArray encryptedData(cipher.encryptedSize(testData.size()));
+        encryptedData.resize(
+                cipher.encryptInto(testData.data(), testData.size(), encryptedData.data(), encryptedData.size()));
+
+        REQUIRE(VirgilCipher().decryptWithKey(encryptedData, aliceId, aliceKeyPair.privateKey()) == testData);
+        REQUIRE_THROWS(VirgilCipher().decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()));
+    }
+}
+
+TEST_CASE("VirgilCipher: encrypt several times with the same cipher", "[cipher]") {
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+    VirgilByteArray bobId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair bobKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilByteArray alicePassword = str2bytes("alice secret");
+
+    VirgilCipher cipher;
+    cipher.addKeyRecipient(bobId, bobKeyPair.publicKey());
+    cipher.addPasswordRecipient(alicePassword);
+
+    for (auto i = 0; i < 3; ++i) {
+        VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+        REQUIRE(VirgilCipher().decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()) == testData);
+        REQUIRE(VirgilCipher().decryptWithPassword(encryptedData, alicePassword) == testData);
+    }
+}
+
+TEST_CASE("VirgilCipher: encrypt for recipient set", "[cipher]") {
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+    VirgilByteArray bobId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilByteArray johnId = str2bytes("968dc52d-2045-4abe-ab51-0b04737cac76");
+    VirgilKeyPair bobKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilKeyPair johnKeyPair = VirgilKeyPair::generateRecommended();
+
+    VirgilRecipientSet recipients;
+    recipients.addKeyRecipient(bobId, bobKeyPair.publicKey());
+    recipients.addKeyRecipient(johnId, johnKeyPair.publicKey());
+
+    SECTION("manage recipients") {
+        REQUIRE(recipients.size() == 2);
+        REQUIRE(recipients.keyRecipientExists(bobId));
+        REQUIRE_THROWS(recipients.addKeyRecipient(bobId, johnKeyPair.publicKey()));
+        REQUIRE_THROWS(recipients.addKeyRecipient(str2bytes("alice"), str2bytes("malformed key")));
+        recipients.removeKeyRecipient(bobId);
+        REQUIRE_FALSE(recipients.keyRecipientExists(bobId));
+        recipients.clear();
+        REQUIRE(recipients.isEmpty());
+    }
+
+    SECTION("with several ciphers") {
+        for (auto i = 0; i < 3; ++i) {
+            VirgilCipher cipher;
+            cipher.addKeyRecipients(recipients);
+            REQUIRE(cipher.keyRecipientExists(bobId));
+            REQUIRE(cipher.keyRecipientExists(johnId));
+            VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+            REQUIRE(VirgilCipher().decryptWithKey(encryptedData, bobId, bobKeyPair.privateKey()) == testData);
+            REQUIRE(VirgilCipher().decryptWithKey(encryptedData, johnId, johnKeyPair.privateKey()) == testData);
+        }
+    }
+
+    SECTION("with the same cipher") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipients(recipients);
+        for (auto i = 0; i < 3; ++i) {
+            VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+            REQUIRE(VirgilCipher().decryptWithKey(encryptedData, johnId, johnKeyPair.privateKey()) == testData);
+        }
+    }
+
+    SECTION("with already added recipient") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(bobId, bobKeyPair.publicKey());
+        REQUIRE_THROWS(cipher.addKeyRecipients(recipients));
+        REQUIRE_FALSE(cipher.keyRecipientExists(johnId));
+    }
+}
+
+TEST_CASE("VirgilCipher: lookup recipients within large content info", "[cipher]") {
+    VirgilCipher cipher;
+    VirgilKeyPair commonKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilByteArray testData = str2bytes("this string will be encrypted for a lot of recipients");
+    VirgilByteArray alicePassword = str2bytes("alice secret");
+
+    for (auto i = 0; i < 1024; ++i) {
+        cipher.addKeyRecipient(str2bytes("recipient-" + std::to_string(i)), commonKeyPair.publicKey());
+    }
+    cipher.addPasswordRecipient(alicePassword);
+
+    VirgilByteArray encryptedData = cipher.encrypt(testData, false);
+    VirgilByteArray contentInfo = cipher.getContentInfo();
+
+    VirgilCipher decipher;
+    decipher.setContentInfo(contentInfo);
+    REQUIRE(decipher.keyRecipientExists(str2bytes("recipient-0")));
+    REQUIRE(decipher.keyRecipientExists(str2bytes("recipient-1023")));
+    REQUIRE_FALSE(decipher.keyRecipientExists(str2bytes("recipient-1024")));
+    REQUIRE(decipher.getContentInfo() == contentInfo);
+
+    SECTION("decrypt for key recipients") {
+        for (const auto& recipientId : { "recipient-1023", "recipient-512", "recipient-0" }) {
+            REQUIRE(decipher.decryptWithKey(encryptedData, str2bytes(recipientId), commonKeyPair.privateKey()) ==
+                    testData);
+        }
+    }
+
+    SECTION("decrypt for password recipient") {
+        REQUIRE(decipher.decryptWithPassword(encryptedData, alicePassword) == testData);
+    }
+
+    SECTION("remove recipient") {
+        decipher.removeKeyRecipient(str2bytes("recipient-512"));
+        REQUIRE_FALSE(decipher.keyRecipientExists(str2bytes("recipient-512")));
+        REQUIRE(decipher.keyRecipientExists(str2bytes("recipient-513")));
+        REQUIRE_THROWS(decipher.decryptWithKey(
+                encryptedData, str2bytes("recipient-512"), commonKeyPair.privateKey()));
+    }
+}
+
+TEST_CASE("VirgilCipher: encrypt and decrypt with content encryption algorithm", "[cipher]") {
+    const VirgilByteArray password = str2bytes("password");
+    const VirgilByteArray testData = str2bytes("this string will be encrypted");
+
+    VirgilCipher cipher;
+    VirgilCipher decipher;
+    cipher.addPasswordRecipient(password);
+    REQUIRE(cipher.getContentEncryptionAlgorithm() == VirgilSymmetricCipher::Algorithm::AES_256_GCM);
+
+    for (const auto algorithm : {
+            VirgilSymmetricCipher::Algorithm::AES_128_GCM, VirgilSymmetricCipher::Algorithm::AES_256_GCM }) {
+        cipher.setContentEncryptionAlgorithm(algorithm);
+        REQUIRE(cipher.getContentEncryptionAlgorithm() == algorithm);
+
+        const VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+        REQUIRE(decipher.decryptWithPassword(encryptedData, password) == testData);
+    }
+
+    for (const auto algorithm : {
+            VirgilSymmetricCipher::Algorithm::AES_128_CBC, VirgilSymmetricCipher::Algorithm::AES_256_CBC }) {
+        REQUIRE_THROWS(cipher.setContentEncryptionAlgorithm(algorithm));
+        REQUIRE(cipher.getContentEncryptionAlgorithm() == VirgilSymmetricCipher::Algorithm::AES_256_GCM);
+    }
+}
+
+TEST_CASE("VirgilCipher: decrypt padded content with detached content info", "[cipher]") {
+    const VirgilByteArray password = str2bytes("password");
+    VirgilRandom random(str2bytes("test_cipher"));
+
+    // Content encrypted with AES-256-CBC can only come from other producers, so it is built by hand.
+    VirgilSymmetricCipher contentCipher(VirgilSymmetricCipher::Algorithm::AES_256_CBC);
+    const VirgilByteArray contentKey = random.randomize(contentCipher.keyLength());
+    const VirgilByteArray contentIV = random.randomize(contentCipher.ivSize());
+    contentCipher.setEncryptionKey(contentKey);
+    contentCipher.setPadding(VirgilSymmetricCipher::Padding::PKCS7);
+
+    VirgilPBE pbe(VirgilPBE::Algorithm::PKCS5, random.randomize(16));
+    VirgilCMSPasswordRecipient passwordRecipient;
+    passwordRecipient.keyEncryptionAlgorithm = pbe.toAsn1();
+    passwordRecipient.encryptedKey = pbe.encrypt(contentKey, password);
+
+    for (const size_t testDataSize : { 0, 15, 16, 33 }) {
+        const VirgilByteArray testData = random.randomize(testDataSize);
+        const VirgilByteArray encryptedData = contentCipher.crypt(testData, contentIV);
+        REQUIRE(encryptedData.size() > testData.size());
+
+        VirgilCMSEnvelopedData envelopedData;
+        envelopedData.passwordRecipients.push_back(passwordRecipient);
+        envelopedData.encryptedContent.contentEncryptionAlgorithm = contentCipher.toAsn1();
+
+        VirgilCMSContentInfo contentInfo;
+        contentInfo.cmsContent.contentType = VirgilCMSContent::Type::EnvelopedData;
+        contentInfo.cmsContent.content = envelopedData.toAsn1();
+
+        VirgilCipher cipher;
+        cipher.setContentInfo(contentInfo.toAsn1());
+        REQUIRE(cipher.decryptWithPassword(encryptedData, password) == testData);
+
+        cipher.setContentInfo(contentInfo.toAsn1());
+        VirgilByteArray decryptedData(encryptedData.size());
+        REQUIRE_THROWS(
+                cipher.decryptInto(encryptedData.data(), encryptedData.size(),
+                        decryptedData.data(), decryptedData.size(), password)
+        );
+
+        cipher.setContentInfo(contentInfo.toAsn1());
+        decryptedData.resize(encryptedData.size() + contentCipher.blockSize());
+        size_t decryptedSize = 0;
+        REQUIRE_NOTHROW(
+                decryptedSize = cipher.decryptInto(encryptedData.data(), encryptedData.size(),
+                        decryptedData.data(), decryptedData.size(), password)
+        );
+        decryptedData.resize(decryptedSize);
+        REQUIRE(decryptedData == testData);
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_content_info_filter.cxx
+ * @brief Covers class VirgilContentInfoFilter
+ */
+
+#include "catch.hpp"
+
+#include <algorithm>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilCipher.h>
+
+#include "VirgilContentInfoFilter.h"
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCipher;
+using virgil::crypto::internal::VirgilContentInfoFilter;
+
+TEST_CASE("Content Info Filter: extract content info without copying encrypted data", "[content-info-filter]") {
+    VirgilCipher cipher;
+    cipher.addPasswordRecipient(str2bytes("password"));
+    cipher.encrypt(str2bytes("data"), false);
+    const VirgilByteArray contentInfo = cipher.getContentInfo();
+    const VirgilByteArray encryptedData = str2bytes("encrypted data that follows content info");
+
+    VirgilByteArray data(contentInfo);
+    data.insert(data.end(), encryptedData.cbegin(), encryptedData.cend());
+
+    VirgilContentInfoFilter filter;
+
+    SECTION("from the single chunk") {
+        const size_t offset = filter.filterData(data.data(), data.size());
+        REQUIRE(filter.isContentInfoFound());
+        REQUIRE(offset == contentInfo.size());
+        REQUIRE(filter.popContentInfo() == contentInfo);
+        REQUIRE(filter.popEncryptedData().empty());
+    }
+
+    SECTION("from the small chunks") {
+        const size_t chunkSize = 5;
+        VirgilByteArray actualEncryptedData;
+        for (size_t pos = 0; pos < data.size(); pos += chunkSize) {
+            const size_t size = std::min(chunkSize, data.size() - pos);
+            if (filter.isWaitingData()) {
+                const size_t offset = filter.filterData(data.data() + pos, size);
+                REQUIRE(offset <= size);
+                actualEncryptedData = filter.popEncryptedData();
+                actualEncryptedData.insert(actualEncryptedData.end(), data.cbegin() + pos + offset,
+                        data.cbegin() + pos + size);
+            } else {
+                actualEncryptedData.insert(actualEncryptedData.end(), data.cbegin() + pos, data.cbegin() + pos + size);
+            }
+        }
+        REQUIRE(filter.isContentInfoFound());
+        REQUIRE(filter.popContentInfo() == contentInfo);
+        REQUIRE(actualEncryptedData == encryptedData);
+    }
+
+    SECTION("when content info is absent") {
+        const size_t offset = filter.filterData(encryptedData.data(), encryptedData.size());
+        REQUIRE(filter.isContentInfoAbsent());
+        REQUIRE(offset == 0);
+        REQUIRE(filter.popEncryptedData().empty());
+    }
+
+    SECTION("and copy encrypted data for the byte array input") {
+        filter.filterData(data);
+        REQUIRE(filter.isContentInfoFound());
+        REQUIRE(filter.popContentInfo() == contentInfo);
+        REQUIRE(filter.popEncryptedData() == encryptedData);
+    }
+
+    SECTION("after reset") {
+        filter.filterData(data);
+        filter.reset();
+        filter.filterData(encryptedData);
+        REQUIRE(filter.isContentInfoAbsent());
+        REQUIRE(filter.popEncryptedData() == encryptedData);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_data_adapters.cxx
+ * @brief Covers classes VirgilDataSourceReader, VirgilDataReaderSource, VirgilDataSinkWriter, VirgilDataWriterSink
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilDataSourceReader.h>
+#include <virgil/crypto/VirgilDataReaderSource.h>
+#include <virgil/crypto/VirgilDataSinkWriter.h>
+#include <virgil/crypto/VirgilDataWriterSink.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
+#include <virgil/crypto/stream/VirgilBytesDataSink.h>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataSourceReader;
+using virgil::crypto::VirgilDataReaderSource;
+using virgil::crypto::VirgilDataSinkWriter;
+using virgil::crypto::VirgilDataWriterSink;
+using virgil::crypto::stream::VirgilBytesDataSource;
+using virgil::crypto::stream::VirgilBytesDataSink;
+
+TEST_CASE("Data adapters: read data from the source to the caller buffer", "[data-adapters]") {
+    const VirgilByteArray data = str2bytes("0123456789");
+    VirgilBytesDataSource source(data, 4);
+    VirgilDataSourceReader reader(source);
+
+    unsigned char buffer[3];
+    VirgilByteArray actual;
+    while (reader.hasData()) {
+        const size_t readSize = reader.readInto(buffer, sizeof(buffer));
+        REQUIRE(readSize <= sizeof(buffer));
+        actual.insert(actual.end(), buffer, buffer + readSize);
+    }
+    REQUIRE(actual == data);
+    REQUIRE(reader.readInto(buffer, sizeof(buffer)) == 0);
+}
+
+TEST_CASE("Data adapters: read data from the reader as byte arrays", "[data-adapters]") {
+    const VirgilByteArray data = str2bytes("0123456789");
+    VirgilBytesDataSource bytesSource(data);
+    VirgilDataReaderSource source(bytesSource, 4);
+
+    REQUIRE(source.read() == str2bytes("0123"));
+    REQUIRE(source.read() == str2bytes("4567"));
+    REQUIRE(source.read() == str2bytes("89"));
+    REQUIRE_FALSE(source.hasData());
+}
+
+TEST_CASE("Data adapters: write data through the adapters", "[data-adapters]") {
+    VirgilByteArray out;
+    VirgilBytesDataSink bytesSink(out);
+    VirgilDataSinkWriter writer(bytesSink);
+    VirgilDataWriterSink sink(writer);
+
+    REQUIRE(sink.isGood());
+    sink.write(str2bytes("abc"));
+    const VirgilByteArray tail = str2bytes("def");
+    writer.write(tail.data(), tail.size());
+    REQUIRE(out == str2bytes("abcdef"));
+}
+
+#endif // VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
@@ -89,6 +89,18 @@ TEST_CASE("SHA-256", "[hash]") {
                 "7c4fbf484498d21b487b9d61de8914b2eadaf2698712936d47c3ada2558f6788");
         REQUIRE(hash.hash(testVector) == testVectorHash);
     }
+    SECTION("Test vector FIPS 180-2 two blocks message") {
+        VirgilByteArray testVector = str2bytes("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+        VirgilByteArray testVectorHash = hex2bytes(
+                "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+        REQUIRE(hash.hash(testVector) == testVectorHash);
+    }
+    SECTION("Test vector FIPS 180-2 long message") {
+        VirgilByteArray testVector(1000000, 'a');
+        VirgilByteArray testVectorHash = hex2bytes(
+                "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+        REQUIRE(hash.hash(testVector) == testVectorHash);
+    }
 }
 
 TEST_CASE("SHA-384", "[hash]") {
@@ -151,3 +163,63 @@ TEST_CASE("HMAC-MD5", "[HMAC hash]") {
         REQUIRE(hash.hmac(key, testVector) == testVectorHash);
     }
 }
+
+TEST_CASE("Hash data given as pointer and length", "[hash]") {
+    VirgilByteArray data = str2bytes("data to be hashed with pointer and length");
+    VirgilByteArray key = str2bytes("hmac key");
+    VirgilHash hash(VirgilHash::Algorithm::SHA256);
+
+    SECTION("at once") {
+        REQUIRE(hash.hash(data.data(), data.size()) == hash.hash(data));
+    }
+    SECTION("by chunks") {
+        hash.start();
+        hash.update(data.data(), 10);
+        hash.update(data.data() + 10, data.size() - 10);
+        REQUIRE(hash.finish() == hash.hash(data));
+    }
+    SECTION("with HMAC by chunks") {
+        hash.hmacStart(key);
+        hash.hmacUpdate(data.data(), 10);
+        hash.hmacUpdate(data.data() + 10, data.size() - 10);
+        REQUIRE(hash.hmacFinish() == hash.hmac(key, data));
+    }
+}
+
+TEST_CASE("Hash messages in batch", "[hash]") {
+    std::vector<VirgilByteArray> messages;
+    for (size_t size = 0; size < 300; size += 7) {
+        messages.push_back(VirgilByteArray(size, static_cast<unsigned char>(size)));
+    }
+    std::vector<VirgilHash::InputSegment> segments;
+    for (const auto& message : messages) {
+        segments.push_back({ message.data(), message.size() });
+    }
+
+    for (auto algorithm : { VirgilHash::Algorithm::SHA256, VirgilHash::Algorithm::SHA512 }) {
+        VirgilHash hash(algorithm);
+        VirgilByteArray expectedDigests;
+        for (const auto& message : messages) {
+            auto digest = hash.hash(message);
+            expectedDigests.insert(expectedDigests.end(), digest.begin(), digest.end());
+        }
+
+        SECTION(std::to_string(algorithm) + " within calling thread") {
+            REQUIRE(hash.hashBatch(segments) == expectedDigests);
+        }
+        SECTION(std::to_string(algorithm) + " within many threads") {
+            REQUIRE(hash.hashBatch(segments, 4) == expectedDigests);
+        }
+    }
+
+    VirgilHash hash(VirgilHash::Algorithm::SHA256);
+    SECTION("with no messages") {
+        REQUIRE(hash.hashBatch({}).empty());
+    }
+    SECTION("with zero threads") {
+        REQUIRE_THROWS(hash.hashBatch(segments, 0));
+    }
+    SECTION("with undefined message data") {
+        REQUIRE_THROWS(hash.hashBatch({ { nullptr, 1 } }));
+    }
+}
@@ -0,0 +1,144 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_key_handle.cxx
+ * @brief Covers classes VirgilPrivateKeyHandle and VirgilPublicKeyHandle
+ */
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilCipher.h>
+#include <virgil/crypto/VirgilSigner.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilCryptoException.h>
+#include <virgil/crypto/VirgilPrivateKeyHandle.h>
+#include <virgil/crypto/VirgilPublicKeyHandle.h>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCipher;
+using virgil::crypto::VirgilSigner;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilCryptoException;
+using virgil::crypto::VirgilPrivateKeyHandle;
+using virgil::crypto::VirgilPublicKeyHandle;
+
+TEST_CASE("Key handle: parse keys", "[key-handle]") {
+    VirgilByteArray keyPassword = str2bytes("password");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519, keyPassword);
+
+    SECTION("with valid keys") {
+        REQUIRE_NOTHROW(VirgilPrivateKeyHandle(keyPair.privateKey(), keyPassword));
+        REQUIRE_NOTHROW(VirgilPublicKeyHandle(keyPair.publicKey()));
+    }
+
+    SECTION("with wrong private key password") {
+        REQUIRE_THROWS_AS(VirgilPrivateKeyHandle(keyPair.privateKey(), str2bytes("wrong")), VirgilCryptoException);
+    }
+
+    SECTION("with malformed keys") {
+        REQUIRE_THROWS_AS(VirgilPrivateKeyHandle(str2bytes("malformed")), VirgilCryptoException);
+        REQUIRE_THROWS_AS(VirgilPublicKeyHandle(str2bytes("malformed")), VirgilCryptoException);
+    }
+}
+
+TEST_CASE("Key handle: sign and verify", "[key-handle]") {
+    VirgilByteArray testData = str2bytes("this string will be signed");
+    VirgilByteArray keyPassword = str2bytes("password");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519, keyPassword);
+
+    VirgilPrivateKeyHandle privateKey(keyPair.privateKey(), keyPassword);
+    VirgilPublicKeyHandle publicKey(keyPair.publicKey());
+
+    VirgilSigner signer;
+
+    SECTION("with handles") {
+        VirgilByteArray sign = signer.sign(testData, privateKey);
+        REQUIRE(signer.verify(testData, sign, publicKey));
+        REQUIRE_FALSE(signer.verify(str2bytes("malformed data"), sign, publicKey));
+    }
+
+    SECTION("interchangeably with raw keys") {
+        REQUIRE(signer.verify(testData, signer.sign(testData, privateKey), keyPair.publicKey()));
+        REQUIRE(signer.verify(testData, signer.sign(testData, keyPair.privateKey(), keyPassword), publicKey));
+    }
+
+    SECTION("with copied handle") {
+        VirgilPrivateKeyHandle privateKeyCopy = privateKey;
+        REQUIRE(signer.verify(testData, signer.sign(testData, privateKeyCopy), publicKey));
+    }
+}
+
+TEST_CASE("Key handle: encrypt and decrypt", "[key-handle]") {
+    VirgilByteArray testData = str2bytes("this string will be encrypted");
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_X25519);
+
+    VirgilPrivateKeyHandle privateKey(keyPair.privateKey());
+    VirgilPublicKeyHandle publicKey(keyPair.publicKey());
+
+    SECTION("with handles") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(recipientId, publicKey);
+        REQUIRE(cipher.keyRecipientExists(recipientId));
+        VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+        REQUIRE(VirgilCipher().decryptWithKey(encryptedData, recipientId, privateKey) == testData);
+    }
+
+    SECTION("interchangeably with raw keys") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(recipientId, publicKey);
+        VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+        REQUIRE(VirgilCipher().decryptWithKey(encryptedData, recipientId, keyPair.privateKey()) == testData);
+    }
+
+    SECTION("with wrong recipient") {
+        VirgilCipher cipher;
+        cipher.addKeyRecipient(recipientId, publicKey);
+        VirgilByteArray encryptedData = cipher.encrypt(testData, true);
+        REQUIRE_THROWS_AS(
+                VirgilCipher().decryptWithKey(encryptedData, str2bytes("wrong id"), privateKey),
+                VirgilCryptoException);
+    }
+
+    SECTION("compute shared key") {
+        VirgilKeyPair otherKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_X25519);
+        REQUIRE(VirgilCipher::computeShared(VirgilPublicKeyHandle(otherKeyPair.publicKey()), privateKey) ==
+                VirgilCipher::computeShared(otherKeyPair.publicKey(), keyPair.privateKey()));
+    }
+}
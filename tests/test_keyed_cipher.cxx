@@ -0,0 +1,95 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_keyed_cipher.cxx
+ * @brief Covers class VirgilKeyedCipher
+ */
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/foundation/VirgilKeyedCipher.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::foundation::VirgilKeyedCipher;
+using virgil::crypto::foundation::VirgilSymmetricCipher;
+
+TEST_CASE("VirgilKeyedCipher: encrypt and decrypt many messages with the same key", "[keyed-cipher]") {
+    VirgilByteArray key(32, 0xAA);
+    VirgilByteArray authData = str2bytes("additional data");
+    VirgilKeyedCipher cipher(VirgilSymmetricCipher::Algorithm::AES_256_GCM, key);
+
+    REQUIRE(cipher.keyLength() == 32);
+    REQUIRE(cipher.nonceSize() == 12);
+    REQUIRE(cipher.authTagLength() == 16);
+
+    SECTION("and compare with VirgilSymmetricCipher") {
+        for (unsigned char messageIndex = 0; messageIndex < 8; ++messageIndex) {
+            VirgilByteArray nonce(cipher.nonceSize(), messageIndex);
+            VirgilByteArray plainText(100 * messageIndex, messageIndex);
+
+            VirgilSymmetricCipher expectedCipher(VirgilSymmetricCipher::Algorithm::AES_256_GCM);
+            expectedCipher.setEncryptionKey(key);
+            expectedCipher.setAuthData(authData);
+            VirgilByteArray expectedCipherText = expectedCipher.crypt(plainText, nonce);
+
+            VirgilByteArray cipherText = cipher.encrypt(plainText, nonce, authData);
+            REQUIRE(cipherText == expectedCipherText);
+            REQUIRE(cipher.decrypt(cipherText, nonce, authData) == plainText);
+        }
+    }
+    SECTION("and detect modified cipher text") {
+        VirgilByteArray nonce(cipher.nonceSize(), 0x01);
+        VirgilByteArray cipherText = cipher.encrypt(str2bytes("message"), nonce, authData);
+        cipherText[0] ^= 0x01;
+        REQUIRE_THROWS(cipher.decrypt(cipherText, nonce, authData));
+        cipherText[0] ^= 0x01;
+        REQUIRE_THROWS(cipher.decrypt(cipherText, nonce, str2bytes("other data")));
+        REQUIRE(cipher.decrypt(cipherText, nonce, authData) == str2bytes("message"));
+    }
+}
+
+TEST_CASE("VirgilKeyedCipher: create with invalid parameters", "[keyed-cipher]") {
+    SECTION("not authenticated algorithm") {
+        REQUIRE_THROWS(VirgilKeyedCipher(VirgilSymmetricCipher::Algorithm::AES_256_CBC, VirgilByteArray(32, 0xAA)));
+    }
+    SECTION("wrong key size") {
+        REQUIRE_THROWS(VirgilKeyedCipher(VirgilSymmetricCipher::Algorithm::AES_256_GCM, VirgilByteArray(5, 0xAA)));
+    }
+}
@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_mapped_file_data_source.cxx
+ * @brief Covers classes VirgilMappedFileDataSource and VirgilMappedFileDataSink
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/stream/VirgilMappedFileDataSink.h>
+#include <virgil/crypto/stream/VirgilMappedFileDataSource.h>
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::stream::VirgilMappedFileDataSink;
+using virgil::crypto::stream::VirgilMappedFileDataSource;
+
+static const char* const kTestFilePath = "test_mapped_file_data_source.bin";
+
+static VirgilByteArray make_test_data(size_t size) {
+    VirgilByteArray data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<unsigned char>(i * 31 + i / 251);
+    }
+    return data;
+}
+
+static VirgilByteArray read_file(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    return VirgilByteArray(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("VirgilMappedFileDataSource: open non existing file", "[mapped-file-data-source]") {
+    REQUIRE_THROWS(VirgilMappedFileDataSource("invalid_path_to_file"));
+}
+
+TEST_CASE("VirgilMappedFileDataSink: write and read data across mapped windows", "[mapped-file-data-source]") {
+    // Cross the window boundary of the underlying file mapping.
+    const VirgilByteArray testData = make_test_data(8 * 1024 * 1024 + 12345);
+    const size_t kPortionSize = 100000;
+
+    {
+        VirgilMappedFileDataSink sink(kTestFilePath);
+        REQUIRE(sink.isGood());
+        for (size_t offset = 0; offset < testData.size(); offset += kPortionSize) {
+            const size_t end = std::min(offset + kPortionSize, testData.size());
+            sink.write(VirgilByteArray(testData.cbegin() + offset, testData.cbegin() + end));
+        }
+        REQUIRE_NOTHROW(sink.close());
+        REQUIRE_FALSE(sink.isGood());
+    }
+
+    REQUIRE(read_file(kTestFilePath) == testData);
+
+    SECTION("read the whole file") {
+        VirgilMappedFileDataSource source(kTestFilePath, kPortionSize);
+        REQUIRE(source.size() == testData.size());
+        VirgilByteArray readData;
+        while (source.hasData()) {
+            const VirgilByteArray portion = source.read();
+            REQUIRE(portion.size() <= kPortionSize);
+            readData.insert(readData.end(), portion.cbegin(), portion.cend());
+        }
+        REQUIRE(readData == testData);
+    }
+
+    SECTION("read after seek") {
+        VirgilMappedFileDataSource source(kTestFilePath, 64);
+        source.seek(testData.size() - 10);
+        REQUIRE(source.read() == VirgilByteArray(testData.cend() - 10, testData.cend()));
+        REQUIRE_FALSE(source.hasData());
+
+        source.seek(100);
+        REQUIRE(source.read() == VirgilByteArray(testData.cbegin() + 100, testData.cbegin() + 164));
+
+        source.seek(testData.size() + 1);
+        REQUIRE_FALSE(source.hasData());
+    }
+
+    std::remove(kTestFilePath);
+}
+
+TEST_CASE("VirgilMappedFileDataSink: write nothing", "[mapped-file-data-source]") {
+    {
+        VirgilMappedFileDataSink sink(kTestFilePath);
+    }
+    REQUIRE(read_file(kTestFilePath).empty());
+
+    VirgilMappedFileDataSource source(kTestFilePath);
+    REQUIRE_FALSE(source.hasData());
+
+    std::remove(kTestFilePath);
+}
+
+#endif // VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
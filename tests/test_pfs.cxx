@@ -139,3 +139,37 @@ SCENARIO("PFS decrypt.", "[pfs]") {
         testFunction(test::data::getCaseWithoutOTC());
     }
 }
+
+SCENARIO("PFS default cipher processes many messages.", "[pfs]") {
+    using virgil::crypto::primitive::VirgilOperationCipher;
+    using virgil::crypto::VirgilByteArray;
+
+    auto cipher = VirgilOperationCipher::getDefault();
+    REQUIRE(cipher.getKeySize() == 32);
+    REQUIRE(cipher.getNonceSize() == 12);
+
+    auto keyA = VirgilByteArray(cipher.getKeySize(), 0xAA);
+    auto keyB = VirgilByteArray(cipher.getKeySize(), 0xBB);
+    auto nonce = VirgilByteArray(cipher.getNonceSize(), 0x01);
+    auto authData = virgil::crypto::str2bytes("additional data");
+    auto plainText = virgil::crypto::str2bytes("message to be encrypted");
+
+    GIVEN("Same key for consecutive messages.") {
+        auto cipherText1 = cipher.encrypt(plainText, keyA, nonce, authData);
+        auto cipherText2 = cipher.encrypt(plainText, keyA, nonce, authData);
+        REQUIRE(bytes2hex(cipherText1) == bytes2hex(cipherText2));
+        REQUIRE(bytes2hex(cipher.decrypt(cipherText1, keyA, nonce, authData)) == bytes2hex(plainText));
+        REQUIRE(bytes2hex(cipher.decrypt(cipherText2, keyA, nonce, authData)) == bytes2hex(plainText));
+    }
+
+    GIVEN("Key changes between messages.") {
+        auto cipherTextA = cipher.encrypt(plainText, keyA, nonce, authData);
+        auto cipherTextB = cipher.encrypt(plainText, keyB, nonce, authData);
+        REQUIRE(bytes2hex(cipherTextA) != bytes2hex(cipherTextB));
+        REQUIRE(bytes2hex(cipher.encrypt(plainText, keyA, nonce, authData)) == bytes2hex(cipherTextA));
+        REQUIRE(bytes2hex(cipher.decrypt(cipherTextB, keyB, nonce, authData)) == bytes2hex(plainText));
+        REQUIRE(bytes2hex(cipher.decrypt(cipherTextA, keyA, nonce, authData)) == bytes2hex(plainText));
+        REQUIRE_THROWS(cipher.decrypt(cipherTextA, keyB, nonce, authData));
+        REQUIRE(bytes2hex(cipher.decrypt(cipherTextA, keyA, nonce, authData)) == bytes2hex(plainText));
+    }
+}
@@ -0,0 +1,170 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_pipeline.cxx
+ * @brief Covers functions pipeline_read() and pipeline_transform()
+ */
+
+#include "catch.hpp"
+
+#include <stdexcept>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilDataSink.h>
+#include <virgil/crypto/VirgilDataSource.h>
+
+#include "VirgilPipeline.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataSink;
+using virgil::crypto::VirgilDataSource;
+using virgil::crypto::internal::pipeline_read;
+using virgil::crypto::internal::pipeline_transform;
+
+namespace {
+
+class CountingDataSource : public VirgilDataSource {
+public:
+    CountingDataSource(size_t portionsNum, size_t failAt = 0) : portionsNum_(portionsNum), failAt_(failAt), read_(0) {}
+
+    bool hasData() override {
+        return read_ < portionsNum_;
+    }
+
+    VirgilByteArray read() override {
+        if (++read_ == failAt_) {
+            throw std::runtime_error("read failed");
+        }
+        return VirgilByteArray(read_ % 7 + 1, static_cast<unsigned char>(read_));
+    }
+
+private:
+    const size_t portionsNum_;
+    const size_t failAt_;
+    size_t read_;
+};
+
+class CollectingDataSink : public VirgilDataSink {
+public:
+    explicit CollectingDataSink(size_t writesMax = 0) : writesMax_(writesMax), writes_(0) {}
+
+    bool isGood() override {
+        return writesMax_ == 0 || writes_ < writesMax_;
+    }
+
+    void write(const VirgilByteArray& data) override {
+        ++writes_;
+        data_.insert(data_.end(), data.cbegin(), data.cend());
+    }
+
+    const VirgilByteArray& data() const {
+        return data_;
+    }
+
+private:
+    const size_t writesMax_;
+    size_t writes_;
+    VirgilByteArray data_;
+};
+
+void invert(const VirgilByteArray& input, VirgilByteArray& output) {
+    for (auto byte : input) {
+        output.push_back(static_cast<unsigned char>(~byte));
+    }
+}
+
+}
+
+TEST_CASE("Pipeline: transform data", "[pipeline]") {
+    CountingDataSource expectedSource(1000);
+    CollectingDataSink expectedSink;
+    pipeline_transform(expectedSource, expectedSink, 0, invert);
+    REQUIRE_FALSE(expectedSink.data().empty());
+
+    for (size_t depth : { 1, 2, 8 }) {
+        CountingDataSource source(1000);
+        CollectingDataSink sink;
+        pipeline_transform(source, sink, depth, invert);
+        REQUIRE(sink.data() == expectedSink.data());
+    }
+}
+
+TEST_CASE("Pipeline: stop when sink becomes bad", "[pipeline]") {
+    CountingDataSource expectedSource(1000);
+    CollectingDataSink expectedSink(10);
+    pipeline_transform(expectedSource, expectedSink, 0, invert);
+
+    CountingDataSource source(1000);
+    CollectingDataSink sink(10);
+    pipeline_transform(source, sink, 4, invert);
+    REQUIRE(sink.data() == expectedSink.data());
+}
+
+TEST_CASE("Pipeline: read data", "[pipeline]") {
+    CountingDataSource expectedSource(500);
+    VirgilByteArray expectedData;
+    pipeline_read(expectedSource, 0, [&expectedData](const VirgilByteArray& data) {
+        expectedData.insert(expectedData.end(), data.cbegin(), data.cend());
+    });
+
+    CountingDataSource source(500);
+    VirgilByteArray actualData;
+    pipeline_read(source, 3, [&actualData](const VirgilByteArray& data) {
+        actualData.insert(actualData.end(), data.cbegin(), data.cend());
+    });
+    REQUIRE(actualData == expectedData);
+}
+
+TEST_CASE("Pipeline: propagate errors", "[pipeline]") {
+    SECTION("thrown by the source") {
+        CountingDataSource source(1000, 100);
+        CollectingDataSink sink;
+        REQUIRE_THROWS_AS(pipeline_transform(source, sink, 4, invert), std::runtime_error);
+    }
+
+    SECTION("thrown by the transformation") {
+        CountingDataSource source(1000);
+        CollectingDataSink sink;
+        size_t calls = 0;
+        REQUIRE_THROWS_AS(pipeline_transform(source, sink, 4,
+                [&calls](const VirgilByteArray&, VirgilByteArray&) {
+                    if (++calls == 50) {
+                        throw std::logic_error("transform failed");
+                    }
+                }), std::logic_error);
+    }
+}
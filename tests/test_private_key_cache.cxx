@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_private_key_cache.cxx
+ * @brief Covers class VirgilPrivateKeyCache
+ */
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilCryptoException.h>
+#include <virgil/crypto/foundation/VirgilAsymmetricCipher.h>
+#include <virgil/crypto/foundation/VirgilPrivateKeyCache.h>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilCryptoException;
+using virgil::crypto::foundation::VirgilAsymmetricCipher;
+using virgil::crypto::foundation::VirgilPrivateKeyCache;
+
+static VirgilByteArray parse_private_key(const VirgilByteArray& privateKey, const VirgilByteArray& pwd) {
+    VirgilAsymmetricCipher cipher;
+    cipher.setPrivateKey(privateKey, pwd);
+    return cipher.exportPrivateKeyToDER();
+}
+
+TEST_CASE("Private key cache", "[private-key-cache]") {
+    VirgilByteArray keyPassword = str2bytes("password");
+    VirgilKeyPair keyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519, keyPassword);
+    VirgilKeyPair otherKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519, keyPassword);
+    const VirgilByteArray expectedKey = parse_private_key(keyPair.privateKey(), keyPassword);
+
+    VirgilPrivateKeyCache::disable();
+    VirgilPrivateKeyCache::resetStats();
+
+    SECTION("is disabled by default") {
+        REQUIRE_FALSE(VirgilPrivateKeyCache::isEnabled());
+        REQUIRE(parse_private_key(keyPair.privateKey(), keyPassword) == expectedKey);
+        REQUIRE(VirgilPrivateKeyCache::hits() == 0);
+        REQUIRE(VirgilPrivateKeyCache::misses() == 0);
+        REQUIRE(VirgilPrivateKeyCache::size() == 0);
+    }
+
+    SECTION("with invalid limits") {
+        REQUIRE_THROWS_AS(VirgilPrivateKeyCache::enable(0, 1024), VirgilCryptoException);
+        REQUIRE_THROWS_AS(VirgilPrivateKeyCache::enable(16, 0), VirgilCryptoException);
+        REQUIRE_FALSE(VirgilPrivateKeyCache::isEnabled());
+    }
+
+    SECTION("reuses decrypted key") {
+        VirgilPrivateKeyCache::enable(16, 64 * 1024);
+        REQUIRE(parse_private_key(keyPair.privateKey(), keyPassword) == expectedKey);
+        REQUIRE(VirgilPrivateKeyCache::misses() == 1);
+        REQUIRE(VirgilPrivateKeyCache::hits() == 0);
+        REQUIRE(VirgilPrivateKeyCache::size() == 1);
+        REQUIRE(VirgilPrivateKeyCache::memoryUsage() > 0);
+
+        REQUIRE(parse_private_key(keyPair.privateKey(), keyPassword) == expectedKey);
+        REQUIRE(VirgilPrivateKeyCache::misses() == 1);
+        REQUIRE(VirgilPrivateKeyCache::hits() == 1);
+        REQUIRE(VirgilPrivateKeyCache::size() == 1);
+    }
+
+    SECTION("does not bypass password check") {
+        VirgilPrivateKeyCache::enable(16, 64 * 1024);
+        REQUIRE_NOTHROW(parse_private_key(keyPair.privateKey(), keyPassword));
+        REQUIRE_THROWS_AS(parse_private_key(keyPair.privateKey(), str2bytes("wrong")), VirgilCryptoException);
+        REQUIRE(VirgilPrivateKeyCache::size() == 1);
+    }
+
+    SECTION("does not cache keys without password") {
+        VirgilPrivateKeyCache::enable(16, 64 * 1024);
+        VirgilKeyPair plainKeyPair = VirgilKeyPair::generate(VirgilKeyPair::Type::FAST_EC_ED25519);
+        REQUIRE_NOTHROW(parse_private_key(plainKeyPair.privateKey(), VirgilByteArray()));
+        REQUIRE(VirgilPrivateKeyCache::size() == 0);
+        REQUIRE(VirgilPrivateKeyCache::misses() == 0);
+    }
+
+    SECTION("evicts least recently used key") {
+        VirgilPrivateKeyCache::enable(1, 64 * 1024);
+        parse_private_key(keyPair.privateKey(), keyPassword);
+        parse_private_key(otherKeyPair.privateKey(), keyPassword);
+        REQUIRE(VirgilPrivateKeyCache::size() == 1);
+
+        parse_private_key(otherKeyPair.privateKey(), keyPassword);
+        REQUIRE(VirgilPrivateKeyCache::hits() == 1);
+        parse_private_key(keyPair.privateKey(), keyPassword);
+        REQUIRE(VirgilPrivateKeyCache::hits() == 1);
+        REQUIRE(VirgilPrivateKeyCache::misses() == 3);
+    }
+
+    SECTION("respects memory limit") {
+        VirgilPrivateKeyCache::enable(16, 1);
+        REQUIRE(parse_private_key(keyPair.privateKey(), keyPassword) == expectedKey);
+        REQUIRE(VirgilPrivateKeyCache::size() == 0);
+        REQUIRE(VirgilPrivateKeyCache::memoryUsage() == 0);
+    }
+
+    SECTION("drops entries when disabled") {
+        VirgilPrivateKeyCache::enable(16, 64 * 1024);
+        parse_private_key(keyPair.privateKey(), keyPassword);
+        parse_private_key(otherKeyPair.privateKey(), keyPassword);
+        REQUIRE(VirgilPrivateKeyCache::size() == 2);
+        VirgilPrivateKeyCache::clear();
+        REQUIRE(VirgilPrivateKeyCache::size() == 0);
+        REQUIRE(VirgilPrivateKeyCache::isEnabled());
+        parse_private_key(keyPair.privateKey(), keyPassword);
+        VirgilPrivateKeyCache::disable();
+        REQUIRE(VirgilPrivateKeyCache::size() == 0);
+        REQUIRE(VirgilPrivateKeyCache::memoryUsage() == 0);
+    }
+
+    VirgilPrivateKeyCache::disable();
+    VirgilPrivateKeyCache::resetStats();
+}
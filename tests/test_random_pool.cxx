@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_random_pool.cxx
+ * @brief Covers class VirgilRandomPool
+ */
+
+#include "catch.hpp"
+
+#include <array>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilCryptoException.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+
+#include "VirgilRandomPool.h"
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#include <sys/wait.h>
+#include <unistd.h>
+#define TEST_RANDOM_POOL_FORK 1
+#endif
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilCryptoException;
+using virgil::crypto::foundation::VirgilRandom;
+using virgil::crypto::foundation::internal::VirgilRandomPool;
+
+TEST_CASE("Lease random context", "[random-pool]") {
+    SECTION("Context is reused after lease is released") {
+        mbedtls_ctr_drbg_context* ctx = nullptr;
+        {
+            auto lease = VirgilRandomPool::acquire();
+            REQUIRE(lease);
+            REQUIRE_NOTHROW(ctx = lease.get());
+        }
+        REQUIRE(VirgilRandomPool::idleCount() > 0);
+
+        auto lease = VirgilRandomPool::acquire();
+        REQUIRE(lease.get() == ctx);
+    }
+
+    SECTION("Simultaneous leases own different contexts") {
+        auto first = VirgilRandomPool::acquire();
+        auto second = VirgilRandomPool::acquire();
+        REQUIRE(first.get() != second.get());
+    }
+
+    SECTION("Moved lease keeps context") {
+        auto lease = VirgilRandomPool::acquire();
+        auto ctx = lease.get();
+        auto moved = std::move(lease);
+        REQUIRE_FALSE(lease);
+        REQUIRE(moved.get() == ctx);
+        REQUIRE_THROWS_AS(lease.get(), VirgilCryptoException);
+    }
+}
+
+TEST_CASE("Randomize with pooled contexts", "[random-pool]") {
+    constexpr size_t kSequenceLength = 32;
+
+    SECTION("Different objects produce different sequences") {
+        VirgilRandom first("secure seed");
+        VirgilRandom second("secure seed");
+        REQUIRE(first.randomize(kSequenceLength) != second.randomize(kSequenceLength));
+    }
+
+#if TEST_RANDOM_POOL_FORK
+    SECTION("Child process does not repeat parent sequence") {
+        auto lease = VirgilRandomPool::acquire();
+        std::array<unsigned char, kSequenceLength> parentBytes{};
+        std::array<unsigned char, kSequenceLength> childBytes{};
+
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        pid_t pid = fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0) {
+            close(fds[0]);
+            mbedtls_ctr_drbg_random(lease.get(), childBytes.data(), childBytes.size());
+            const bool written = write(fds[1], childBytes.data(), childBytes.size()) == (ssize_t) childBytes.size();
+            close(fds[1]);
+            _exit(written ? 0 : 1);
+        }
+        close(fds[1]);
+        mbedtls_ctr_drbg_random(lease.get(), parentBytes.data(), parentBytes.size());
+        REQUIRE(read(fds[0], childBytes.data(), childBytes.size()) == (ssize_t) childBytes.size());
+        close(fds[0]);
+
+        int status = 0;
+        REQUIRE(waitpid(pid, &status, 0) == pid);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+        REQUIRE(parentBytes != childBytes);
+    }
+#endif /* TEST_RANDOM_POOL_FORK */
+}
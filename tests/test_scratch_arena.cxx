@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_scratch_arena.cxx
+ * @brief Covers class VirgilScratchArena
+ */
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "VirgilScratchArena.h"
+
+using virgil::crypto::foundation::internal::VirgilScratchArena;
+
+TEST_CASE("Allocate from scratch arena", "[scratch-arena]") {
+    VirgilScratchArena::Scope scratch;
+
+    SECTION("Allocations are aligned and do not overlap") {
+        auto first = scratch.allocate(3);
+        auto second = scratch.allocate(17);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(first) % 16 == 0);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(second) % 16 == 0);
+        REQUIRE(second >= first + 3);
+    }
+
+    SECTION("Allocation bigger than block") {
+        auto data = scratch.allocate(VirgilScratchArena::kBlockSizeMin * 2);
+        std::memset(data, 0xAB, VirgilScratchArena::kBlockSizeMin * 2);
+        REQUIRE(scratch.arena().used() >= VirgilScratchArena::kBlockSizeMin * 2);
+    }
+
+    SECTION("Array allocation of too many items") {
+        REQUIRE_THROWS(scratch.allocateArray<std::uint64_t>(SIZE_MAX / 4));
+    }
+}
+
+TEST_CASE("Release scratch arena scope", "[scratch-arena]") {
+    SECTION("Inner scope zeroizes and releases only own memory") {
+        VirgilScratchArena::Scope outer;
+        auto outerData = outer.allocate(32);
+        std::memset(outerData, 0xAB, 32);
+        const size_t outerUsed = outer.arena().used();
+
+        unsigned char* innerData = nullptr;
+        bool isArenaShared = false;
+        {
+            VirgilScratchArena::Scope inner;
+            isArenaShared = &inner.arena() == &outer.arena();
+            innerData = inner.allocate(64);
+            std::memset(innerData, 0xCD, 64);
+        }
+        REQUIRE(outer.arena().used() == outerUsed);
+        for (size_t i = 0; i < 32; ++i) {
+            REQUIRE(outerData[i] == 0xAB);
+        }
+        // Without thread_local every scope owns the arena, so inner memory is already freed.
+        if (isArenaShared) {
+            for (size_t i = 0; i < 64; ++i) {
+                REQUIRE(innerData[i] == 0);
+            }
+            REQUIRE(outer.allocate(64) == innerData);
+        }
+    }
+
+    SECTION("Only limited memory is retained when outermost scope ends") {
+        const VirgilScratchArena* arena = nullptr;
+        {
+            VirgilScratchArena::Scope scratch;
+            arena = &scratch.arena();
+            (void) scratch.allocate(VirgilScratchArena::kRetainedSizeMax * 2);
+        }
+        VirgilScratchArena::Scope scratch;
+        if (&scratch.arena() == arena) {
+            REQUIRE(scratch.arena().used() == 0);
+            REQUIRE(scratch.arena().capacity() <= VirgilScratchArena::kRetainedSizeMax);
+        }
+    }
+
+    SECTION("Threads do not share scratch memory") {
+        VirgilScratchArena::Scope scratch;
+        const VirgilScratchArena* otherArena = nullptr;
+        std::thread([&otherArena]() {
+            VirgilScratchArena::Scope otherScratch;
+            otherArena = &otherScratch.arena();
+        }).join();
+        REQUIRE(&scratch.arena() != otherArena);
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_secure_byte_array.cxx
+ * @brief Covers class VirgilSecureMemory and VirgilSecureByteArray
+ */
+
+#include "catch.hpp"
+
+#include <cstring>
+
+#include <virgil/crypto/VirgilByteArray.h>
+
+#include "VirgilSecureByteArray.h"
+
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::str2bytes;
+using virgil::crypto::foundation::internal::VirgilSecureMemory;
+using virgil::crypto::foundation::internal::VirgilSecureByteArray;
+using virgil::crypto::foundation::internal::VirgilSecureBytesCopy;
+
+TEST_CASE("Allocate secure memory", "[secure-memory]") {
+    SECTION("Freed slot is zeroized and reused") {
+        auto first = static_cast<unsigned char*>(VirgilSecureMemory::allocate(48));
+        std::memset(first, 0xAB, 48);
+        VirgilSecureMemory::deallocate(first, 48);
+
+        auto second = static_cast<unsigned char*>(VirgilSecureMemory::allocate(60));
+        REQUIRE(second == first);
+        for (size_t i = 0; i < 64; ++i) {
+            REQUIRE(second[i] == 0);
+        }
+        VirgilSecureMemory::deallocate(second, 60);
+    }
+
+    SECTION("Simultaneous allocations do not overlap") {
+        auto first = static_cast<unsigned char*>(VirgilSecureMemory::allocate(32));
+        auto second = static_cast<unsigned char*>(VirgilSecureMemory::allocate(32));
+        REQUIRE((second >= first + 32 || first >= second + 32));
+        VirgilSecureMemory::deallocate(first, 32);
+        VirgilSecureMemory::deallocate(second, 32);
+    }
+
+    SECTION("Allocation bigger than slot") {
+        const size_t size = VirgilSecureMemory::kSlotSizeMax * 3;
+        auto data = static_cast<unsigned char*>(VirgilSecureMemory::allocate(size));
+        std::memset(data, 0xAB, size);
+        VirgilSecureMemory::deallocate(data, size);
+    }
+}
+
+TEST_CASE("Secure byte array", "[secure-memory]") {
+    const VirgilByteArray secret = str2bytes("secret key material");
+
+    SECTION("Grows as ordinary byte array") {
+        VirgilSecureByteArray bytes;
+        for (size_t i = 0; i < 10000; ++i) {
+            bytes.push_back(static_cast<unsigned char>(i));
+        }
+        REQUIRE(bytes.size() == 10000);
+        REQUIRE(bytes[9999] == static_cast<unsigned char>(9999));
+    }
+
+    SECTION("Zeroize keeps capacity") {
+        VirgilSecureByteArray bytes(secret.cbegin(), secret.cend());
+        bytes_zeroize(bytes);
+        REQUIRE(bytes.size() == secret.size());
+        REQUIRE(bytes == VirgilSecureByteArray(secret.size(), 0));
+    }
+
+    SECTION("Plain copy") {
+        VirgilSecureByteArray bytes(secret.cbegin(), secret.cend());
+        const VirgilSecureBytesCopy copy(bytes);
+        REQUIRE(copy.get() == secret);
+    }
+}
@@ -42,6 +42,9 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
+#include <vector>
+
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilSeqCipher.h>
 #include <virgil/crypto/VirgilKeyPair.h>
@@ -118,3 +121,69 @@ TEST_CASE("VirgilSeqCipher: encrypt and decrypt with generated keys", "[seq-ciph
         REQUIRE(testData == decryptedData);
     }
 }
+
+TEST_CASE("VirgilSeqCipher: vectored processing", "[seq-cipher]") {
+    VirgilByteArray password = str2bytes("password");
+
+    VirgilByteArray testData(5000);
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<unsigned char>(i * 31 + 7);
+    }
+
+    const auto makeInputs = [](const VirgilByteArray& data, size_t segmentSize) {
+        std::vector<VirgilSeqCipher::InputSegment> inputs;
+        for (size_t pos = 0; pos < data.size(); pos += segmentSize) {
+            inputs.push_back({ data.data() + pos, std::min(segmentSize, data.size() - pos) });
+        }
+        return inputs;
+    };
+
+    const auto makeOutputs = [](VirgilByteArray& buffer, size_t segmentSize) {
+        std::vector<VirgilSeqCipher::OutputSegment> outputs;
+        for (size_t pos = 0; pos < buffer.size(); pos += segmentSize) {
+            outputs.push_back({ buffer.data() + pos, std::min(segmentSize, buffer.size() - pos) });
+        }
+        return outputs;
+    };
+
+    VirgilSeqCipher encCipher;
+    VirgilSeqCipher decCipher;
+    encCipher.addPasswordRecipient(password);
+
+    VirgilByteArray encryptedData = encCipher.startEncryption();
+    const auto dataInputs = makeInputs(testData, 13);
+    VirgilByteArray encryptedBuffer(VirgilSeqCipher::processvOutputSize(testData.size()));
+    const auto encryptedOutputs = makeOutputs(encryptedBuffer, 7);
+    const size_t encryptedSize = encCipher.processv(
+            dataInputs.data(), dataInputs.size(), encryptedOutputs.data(), encryptedOutputs.size());
+    encryptedData.insert(encryptedData.end(), encryptedBuffer.cbegin(), encryptedBuffer.cbegin() + encryptedSize);
+    bytes_append(encryptedData, encCipher.finish());
+
+    SECTION("produce the same result as sequential processing") {
+        decCipher.startDecryptionWithPassword(password);
+        VirgilByteArray decryptedData = decCipher.process(encryptedData);
+        bytes_append(decryptedData, decCipher.finish());
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("decrypt embedded content info") {
+        decCipher.startDecryptionWithPassword(password);
+        const auto encryptedInputs = makeInputs(encryptedData, 5);
+        VirgilByteArray decryptedBuffer(VirgilSeqCipher::processvOutputSize(encryptedData.size()));
+        const auto decryptedOutputs = makeOutputs(decryptedBuffer, 1000);
+        const size_t decryptedSize = decCipher.processv(
+                encryptedInputs.data(), encryptedInputs.size(), decryptedOutputs.data(), decryptedOutputs.size());
+        VirgilByteArray decryptedData(decryptedBuffer.cbegin(), decryptedBuffer.cbegin() + decryptedSize);
+        bytes_append(decryptedData, decCipher.finish());
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("reject too small output") {
+        decCipher.startDecryptionWithPassword(password);
+        const auto encryptedInputs = makeInputs(encryptedData, 100);
+        VirgilByteArray decryptedBuffer(encryptedData.size());
+        const auto decryptedOutputs = makeOutputs(decryptedBuffer, 1000);
+        REQUIRE_THROWS(decCipher.processv(
+                encryptedInputs.data(), encryptedInputs.size(), decryptedOutputs.data(), decryptedOutputs.size()));
+    }
+}
@@ -68,6 +68,16 @@ static void test_sign_verify(const VirgilKeyPair& keyPair, const VirgilByteArray
         REQUIRE(!signer.verify(malformedData, sign, keyPair.publicKey()));
     }
 
+    SECTION("and verify data given as pointer and length") {
+        REQUIRE(signer.verify(testData.data(), testData.size(), sign, keyPair.publicKey()));
+        REQUIRE(!signer.verify(malformedData.data(), malformedData.size(), sign, keyPair.publicKey()));
+    }
+
+    SECTION("and sign data given as pointer and length") {
+        VirgilByteArray ptrSign = signer.sign(testData.data(), testData.size(), keyPair.privateKey(), keyPassword);
+        REQUIRE(signer.verify(testData, ptrSign, keyPair.publicKey()));
+    }
+
     SECTION("and verify with malformed sign") {
         REQUIRE_THROWS_AS(signer.verify(testData, malformedSign, keyPair.publicKey()), VirgilCryptoException);
     }
@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_staging_buffer.cxx
+ * @brief Covers class VirgilStagingBuffer
+ */
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilDataReader.h>
+
+#include "VirgilStagingBuffer.h"
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilDataReader;
+using virgil::crypto::internal::VirgilStagingBuffer;
+
+namespace {
+
+class PortionReader : public VirgilDataReader {
+public:
+    PortionReader(VirgilByteArray data, size_t portionSize) : data_(std::move(data)), portionSize_(portionSize) {}
+
+    bool hasData() override { return offset_ < data_.size(); }
+
+    size_t readInto(unsigned char* buffer, size_t bufferSize) override {
+        const size_t readSize = std::min(std::min(bufferSize, portionSize_), data_.size() - offset_);
+        std::memcpy(buffer, data_.data() + offset_, readSize);
+        offset_ += readSize;
+        return readSize;
+    }
+
+private:
+    VirgilByteArray data_;
+    size_t portionSize_;
+    size_t offset_ = 0;
+};
+
+}
+
+TEST_CASE("Staging buffer", "[staging-buffer]") {
+    VirgilStagingBuffer buffer(str2bytes("abc"));
+    REQUIRE(buffer.size() == 3);
+
+    SECTION("keeps order of the appended data") {
+        buffer.append(str2bytes("def"));
+        const VirgilByteArray tail = str2bytes("ghi");
+        buffer.append(tail);
+        REQUIRE(buffer.pop(4) == str2bytes("abcd"));
+        REQUIRE(buffer.pop(2) == str2bytes("ef"));
+        buffer.append(str2bytes("jk"));
+        REQUIRE(buffer.pop(100) == str2bytes("ghijk"));
+        REQUIRE(buffer.empty());
+    }
+
+    SECTION("consumes data without copying") {
+        const unsigned char* data = buffer.data();
+        buffer.consume(1);
+        REQUIRE(buffer.data() == data + 1);
+        REQUIRE(buffer.size() == 2);
+        buffer.consume(10);
+        REQUIRE(buffer.empty());
+    }
+
+    SECTION("assembles chunks from the big reads") {
+        VirgilByteArray expected = str2bytes("abc");
+        VirgilByteArray actual;
+        for (int i = 0; i < 100; ++i) {
+            VirgilByteArray read(1000, static_cast<unsigned char>(i));
+            expected.insert(expected.end(), read.cbegin(), read.cend());
+            buffer.append(std::move(read));
+            while (buffer.size() >= 7) {
+                actual.insert(actual.end(), buffer.data(), buffer.data() + 7);
+                buffer.consume(7);
+            }
+        }
+        const VirgilByteArray rest = buffer.pop(7);
+        actual.insert(actual.end(), rest.cbegin(), rest.cend());
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("reads data directly from the reader") {
+        PortionReader reader(str2bytes("defghij"), 3);
+        REQUIRE(buffer.append(reader, 2) == 2);
+        REQUIRE(buffer.append(reader, 10) == 3);
+        REQUIRE(buffer.pop(4) == str2bytes("abcd"));
+        while (reader.hasData()) {
+            buffer.append(reader, 10);
+        }
+        REQUIRE(buffer.pop(100) == str2bytes("efghij"));
+    }
+
+    SECTION("drops all data") {
+        buffer.clear();
+        REQUIRE(buffer.empty());
+        buffer.append(str2bytes("x"));
+        REQUIRE(buffer.pop(1) == str2bytes("x"));
+    }
+}
@@ -268,6 +268,93 @@ TEST_CASE("Stream Cipher: generated keys", "[stream-cipher]") {
     }
 }
 
+TEST_CASE("Stream Cipher: encrypt and decrypt within pipeline", "[stream-cipher]") {
+    VirgilByteArray password = str2bytes("password");
+    VirgilByteArray testData(5000);
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<unsigned char>(i * 13 + 5);
+    }
+    VirgilBytesDataSource testDataSource(testData, 100);
+
+    VirgilByteArray encryptedData;
+    VirgilBytesDataSink encryptedDataSink(encryptedData);
+    VirgilBytesDataSource encryptedDataSource(encryptedData, 64);
+
+    VirgilByteArray decryptedData;
+    VirgilBytesDataSink decryptedDataSink(decryptedData);
+
+    VirgilStreamCipher encCipher;
+    VirgilStreamCipher decCipher;
+    encCipher.addPasswordRecipient(password);
+    REQUIRE(encCipher.getPipelineDepth() == 0);
+
+    SECTION("encrypt within pipeline") {
+        encCipher.setPipelineDepth(4);
+        encCipher.encrypt(testDataSource, encryptedDataSink, true);
+
+        REQUIRE_NOTHROW(decCipher.decryptWithPassword(encryptedDataSource, decryptedDataSink, password));
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("decrypt within pipeline") {
+        encCipher.encrypt(testDataSource, encryptedDataSink, true);
+
+        decCipher.setPipelineDepth(2);
+        REQUIRE_NOTHROW(decCipher.decryptWithPassword(encryptedDataSource, decryptedDataSink, password));
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("fail decryption within pipeline with wrong password") {
+        encCipher.encrypt(testDataSource, encryptedDataSink, true);
+
+        decCipher.setPipelineDepth(2);
+        REQUIRE_THROWS(decCipher.decryptWithPassword(encryptedDataSource, decryptedDataSink, str2bytes("wrong")));
+    }
+}
+
+TEST_CASE("Stream Cipher: encrypt and decrypt within fixed buffers", "[stream-cipher]") {
+    VirgilByteArray password = str2bytes("password");
+    VirgilByteArray testData(200 * 1024);
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<unsigned char>(i * 7 + 3);
+    }
+
+    VirgilByteArray encryptedData;
+    VirgilBytesDataSink encryptedDataSink(encryptedData);
+    VirgilByteArray decryptedData;
+    VirgilBytesDataSink decryptedDataSink(decryptedData);
+
+    VirgilStreamCipher encCipher;
+    VirgilStreamCipher decCipher;
+    encCipher.addPasswordRecipient(password);
+
+    SECTION("data is bigger than the buffer") {
+        VirgilBytesDataSource testDataSource(testData, 100 * 1024);
+        encCipher.encrypt(testDataSource, encryptedDataSink, true);
+
+        VirgilBytesDataSource encryptedDataSource(encryptedData, 7);
+        REQUIRE_NOTHROW(decCipher.decryptWithPassword(encryptedDataSource, decryptedDataSink, password));
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("result is identical to the one produced within pipeline") {
+        VirgilBytesDataSource testDataSource(testData, 1000);
+        encCipher.encrypt(testDataSource, encryptedDataSink, true);
+
+        VirgilByteArray pipelineDecryptedData;
+        VirgilBytesDataSink pipelineDecryptedDataSink(pipelineDecryptedData);
+        VirgilBytesDataSource encryptedDataSource(encryptedData, 1000);
+        decCipher.setPipelineDepth(2);
+        REQUIRE_NOTHROW(decCipher.decryptWithPassword(encryptedDataSource, pipelineDecryptedDataSink, password));
+
+        VirgilBytesDataSource encryptedDataSourceAgain(encryptedData, 1000);
+        decCipher.setPipelineDepth(0);
+        REQUIRE_NOTHROW(decCipher.decryptWithPassword(encryptedDataSourceAgain, decryptedDataSink, password));
+        REQUIRE(testData == decryptedData);
+        REQUIRE(pipelineDecryptedData == decryptedData);
+    }
+}
+
 #else
 #if defined(_MSC_VER)
 #pragma message("Tests for class VirgilStreamCipher are ignored, because VIRGIL_CRYPTO_FEATURE_STREAM_IMPL build parameter is not defined")
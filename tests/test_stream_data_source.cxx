@@ -46,7 +46,10 @@
 #include <virgil/crypto/stream/VirgilStreamDataSource.h>
 
 #include <fstream>
+#include <sstream>
 
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
 using virgil::crypto::stream::VirgilStreamDataSource;
 
 TEST_CASE("VirgilStreamDataSource: check data existence in the bad stream", "[stream-data-source]") {
@@ -55,4 +58,22 @@ TEST_CASE("VirgilStreamDataSource: check data existence in the bad stream", "[st
     REQUIRE_FALSE(dataSource.hasData());
 }
 
+TEST_CASE("VirgilStreamDataSource: seek within the stream", "[stream-data-source]") {
+    std::istringstream stream(std::string(40, 'a') + std::string(40, 'b'));
+    VirgilStreamDataSource dataSource(stream, 32);
+
+    dataSource.seek(40);
+    REQUIRE(dataSource.hasData());
+    REQUIRE(dataSource.read() == str2bytes(std::string(32, 'b')));
+    REQUIRE(dataSource.read() == str2bytes(std::string(8, 'b')));
+    REQUIRE_FALSE(dataSource.hasData());
+
+    dataSource.seek(0);
+    REQUIRE(dataSource.hasData());
+    REQUIRE(dataSource.read() == str2bytes(std::string(32, 'a')));
+
+    dataSource.seek(80);
+    REQUIRE_FALSE(dataSource.hasData());
+}
+
 #endif // VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
@@ -0,0 +1,137 @@
+/**
+ * Copyright (C) 2015-2018 Virgil Security Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ */
+
+/**
+ * @file test_stream_sign_cipher.cxx
+ * @brief Covers class VirgilStreamSignCipher
+ */
+
+#if VIRGIL_CRYPTO_FEATURE_STREAM_IMPL
+
+#include "catch.hpp"
+
+#include <virgil/crypto/VirgilByteArray.h>
+#include <virgil/crypto/VirgilKeyPair.h>
+#include <virgil/crypto/VirgilStreamSignCipher.h>
+#include <virgil/crypto/VirgilStreamSigner.h>
+#include <virgil/crypto/stream/VirgilBytesDataSource.h>
+#include <virgil/crypto/stream/VirgilBytesDataSink.h>
+
+using virgil::crypto::str2bytes;
+using virgil::crypto::VirgilByteArray;
+using virgil::crypto::VirgilKeyPair;
+using virgil::crypto::VirgilStreamSignCipher;
+using virgil::crypto::VirgilStreamSigner;
+using virgil::crypto::stream::VirgilBytesDataSource;
+using virgil::crypto::stream::VirgilBytesDataSink;
+
+TEST_CASE("Stream Sign Cipher: sign, encrypt, decrypt and verify within single pass", "[stream-sign-cipher]") {
+    VirgilByteArray password = str2bytes("password");
+    VirgilByteArray recipientId = str2bytes("2e8176ba-34db-4c65-b977-c5eac687c4ac");
+    VirgilKeyPair recipientKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilKeyPair signerKeyPair = VirgilKeyPair::generateRecommended();
+    VirgilKeyPair otherKeyPair = VirgilKeyPair::generateRecommended();
+
+    VirgilByteArray testData(100 * 1024);
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<unsigned char>(i * 11 + 1);
+    }
+    VirgilBytesDataSource testDataSource(testData, 1000);
+
+    VirgilByteArray encryptedData;
+    VirgilBytesDataSink encryptedDataSink(encryptedData);
+
+    VirgilByteArray decryptedData;
+    VirgilBytesDataSink decryptedDataSink(decryptedData);
+
+    VirgilStreamSignCipher encCipher;
+    VirgilStreamSignCipher decCipher;
+    encCipher.addKeyRecipient(recipientId, recipientKeyPair.publicKey());
+    encCipher.addPasswordRecipient(password);
+
+    SECTION("with signature trailer") {
+        encCipher.encrypt(testDataSource, encryptedDataSink, signerKeyPair.privateKey());
+
+        VirgilBytesDataSource encryptedDataSource(encryptedData, 100);
+        REQUIRE(decCipher.decryptWithKey(encryptedDataSource, decryptedDataSink,
+                recipientId, recipientKeyPair.privateKey(), signerKeyPair.publicKey()));
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("with signature within content info") {
+        encCipher.encrypt(testDataSource, encryptedDataSink, signerKeyPair.privateKey(), VirgilByteArray(), false);
+
+        VirgilBytesDataSource encryptedDataSource(encryptedData);
+        decCipher.setContentInfo(encCipher.getContentInfo());
+        REQUIRE(decCipher.decryptWithPassword(
+                encryptedDataSource, decryptedDataSink, password, signerKeyPair.publicKey()));
+        REQUIRE(testData == decryptedData);
+    }
+
+    SECTION("produce signature compatible with stream signer") {
+        encCipher.encrypt(testDataSource, encryptedDataSink, signerKeyPair.privateKey(), VirgilByteArray(), false);
+
+        const VirgilByteArray signature = encCipher.customParams().getData(str2bytes("signature"));
+        VirgilBytesDataSource signedDataSource(testData);
+        VirgilStreamSigner signer;
+        REQUIRE(signer.verify(signedDataSource, signature, signerKeyPair.publicKey()));
+    }
+
+    SECTION("fail verification with wrong signer") {
+        encCipher.encrypt(testDataSource, encryptedDataSink, signerKeyPair.privateKey());
+
+        VirgilBytesDataSource encryptedDataSource(encryptedData);
+        REQUIRE_FALSE(decCipher.decryptWithPassword(
+                encryptedDataSource, decryptedDataSink, password, otherKeyPair.publicKey()));
+    }
+
+    SECTION("fail decryption of the truncated data") {
+        encCipher.encrypt(testDataSource, encryptedDataSink, signerKeyPair.privateKey());
+        encryptedData.resize(encryptedData.size() - 1);
+
+        VirgilBytesDataSource encryptedDataSource(encryptedData);
+        REQUIRE_THROWS(decCipher.decryptWithPassword(
+                encryptedDataSource, decryptedDataSink, password, signerKeyPair.publicKey()));
+    }
+}
+
+#else
+#if defined(_MSC_VER)
+#pragma message("Tests for class VirgilStreamSignCipher are ignored, because VIRGIL_CRYPTO_FEATURE_STREAM_IMPL build parameter is not defined")
+#else
+#warning "Tests for class VirgilStreamSignCipher are ignored, because VIRGIL_CRYPTO_FEATURE_STREAM_IMPL build parameter is not defined"
+#endif /* _MSC_VER */
+#endif /* VIRGIL_CRYPTO_FEATURE_STREAM_IMPL */
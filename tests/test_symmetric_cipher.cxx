@@ -121,3 +121,49 @@ TEST_CASE("Symmetric Cipher", "[symmetric-cipher]") {
     }
 
 }
+
+static void test_symmetric_cipher_buffers(VirgilSymmetricCipher::Algorithm algorithm) {
+    VirgilByteArray plainData = str2bytes("data to be encrypted with symmetric cipher to the given buffer");
+
+    VirgilSymmetricCipher cipher(algorithm);
+    VirgilByteArray key = VirgilRandom("test").randomize(cipher.keyLength());
+    VirgilByteArray iv = VirgilRandom("test").randomize(cipher.ivSize());
+
+    cipher.setEncryptionKey(key);
+    if (cipher.isSupportPadding()) {
+        cipher.setPadding(VirgilSymmetricCipher::Padding::PKCS7);
+    }
+    cipher.setIV(iv);
+    cipher.reset();
+
+    SECTION("with too small output buffer") {
+        VirgilByteArray encryptedData(plainData.size());
+        REQUIRE_THROWS(cipher.update(plainData.data(), plainData.size(), encryptedData.data(), encryptedData.size()));
+    }
+
+    SECTION("and decrypt with byte array") {
+        VirgilByteArray encryptedData(plainData.size() + 2 * cipher.blockSize() + cipher.authTagLength());
+        size_t writtenBytes = cipher.update(plainData.data(), 7, encryptedData.data(), encryptedData.size());
+        writtenBytes += cipher.update(plainData.data() + 7, plainData.size() - 7,
+                encryptedData.data() + writtenBytes, encryptedData.size() - writtenBytes);
+        writtenBytes += cipher.finish(encryptedData.data() + writtenBytes, encryptedData.size() - writtenBytes);
+        encryptedData.resize(writtenBytes);
+
+        cipher.clear();
+        cipher.setDecryptionKey(key);
+        if (cipher.isSupportPadding()) {
+            cipher.setPadding(VirgilSymmetricCipher::Padding::PKCS7);
+        }
+        REQUIRE(bytes2str(cipher.crypt(encryptedData, iv)) == bytes2str(plainData));
+    }
+}
+
+TEST_CASE("Symmetric Cipher: update and finish to the given buffer", "[symmetric-cipher]") {
+
+    SECTION("AES-256-CBC") {
+        test_symmetric_cipher_buffers(VirgilSymmetricCipher::Algorithm::AES_256_CBC);
+    }
+    SECTION("AES-256-GCM") {
+        test_symmetric_cipher_buffers(VirgilSymmetricCipher::Algorithm::AES_256_GCM);
+    }
+}
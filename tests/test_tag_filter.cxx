@@ -41,7 +41,9 @@
 
 #include "catch.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include <virgil/crypto/VirgilByteArray.h>
 #include <virgil/crypto/VirgilByteArrayUtils.h>
@@ -73,3 +75,51 @@ TEST_CASE("Get TAG", "[tag-filter]") {
         REQUIRE(VirgilByteArrayUtils::bytesToHex(tagFilter.tag()) == "2ccda65f87808b4dcdfebd970b881e95");
     }
 }
+
+TEST_CASE("Filter TAG from the data split to portions", "[tag-filter]") {
+    VirgilTagFilter tagFilter;
+    const size_t kTagLen = 16;
+
+    VirgilByteArray data(300);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<unsigned char>(i);
+    }
+    const VirgilByteArray expectedData(data.cbegin(), data.cend() - kTagLen);
+    const VirgilByteArray expectedTag(data.cend() - kTagLen, data.cend());
+
+    for (size_t portionSize : { 1, 5, 10, 16, 17, 32, 100, 300 }) {
+        tagFilter.reset(kTagLen);
+        VirgilByteArray filteredData;
+        for (size_t offset = 0; offset < data.size(); offset += portionSize) {
+            const size_t size = std::min(portionSize, data.size() - offset);
+            tagFilter.process(data.data() + offset, size, [&](const unsigned char* portion, size_t portionSize) {
+                filteredData.insert(filteredData.end(), portion, portion + portionSize);
+            });
+        }
+        REQUIRE(filteredData == expectedData);
+        REQUIRE(tagFilter.tag() == expectedTag);
+    }
+}
+
+TEST_CASE("Filter TAG and keep block alignment", "[tag-filter]") {
+    VirgilTagFilter tagFilter;
+    const size_t kTagLen = 16;
+    tagFilter.reset(kTagLen);
+
+    const VirgilByteArray data(4200, 0xAB);
+    std::vector<size_t> portionSizes;
+    tagFilter.process(data.data(), 10, [&](const unsigned char*, size_t portionSize) {
+        portionSizes.push_back(portionSize);
+    });
+    tagFilter.process(data.data(), 4102, [&](const unsigned char*, size_t portionSize) {
+        portionSizes.push_back(portionSize);
+    });
+    REQUIRE(portionSizes.size() == 2);
+    REQUIRE(portionSizes[0] % kTagLen == 0);
+    REQUIRE(portionSizes[0] + portionSizes[1] == 4096);
+}
+
+TEST_CASE("Reject too long TAG", "[tag-filter]") {
+    VirgilTagFilter tagFilter;
+    REQUIRE_THROWS(tagFilter.reset(VirgilTagFilter::kTagLenMax + 1));
+}
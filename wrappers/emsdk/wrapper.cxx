@@ -164,6 +164,7 @@ EMSCRIPTEN_BINDINGS(virgil_crypto) {
         .class_function("hasFeatureStreamImpl", &VirgilConfig::hasFeatureStreamImpl)
         .class_function("hasFeaturePythiaImpl", &VirgilConfig::hasFeaturePythiaImpl)
         .class_function("hasFeaturePythiaMultiThread", &VirgilConfig::hasFeaturePythiaMultiThread)
+        .class_function("activeCipherBackend", &VirgilConfig::activeCipherBackend)
     ;
 
     register_vector<unsigned char>("VirgilByteArray")